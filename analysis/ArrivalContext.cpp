@@ -0,0 +1,33 @@
+#include "ArrivalContext.h"
+#include <algorithm>
+
+using namespace std;
+
+ArrivalContext::ArrivalContext()
+    : preset_candidates(nullptr), preset_scores(nullptr), preset_count(-1) {}
+
+void ArrivalContext::reset() {
+    candidates.clear();
+    candidate_scores.clear();
+    slate.clear();
+    slate_ids.clear();
+    slate_scores.clear();
+}
+
+float ArrivalContext::base_score(const Customer& customer, const StoreTable& stores, int slot) const {
+    auto it = lower_bound(candidates.begin(), candidates.end(), slot);
+    if (it != candidates.end() && *it == slot) {
+        return candidate_scores[it - candidates.begin()];
+    }
+    return customer.calculate_store_score(stores, slot);
+}
+
+void ArrivalContext::set_slate(const int* slots, int count, const Customer& customer, const StoreTable& stores) {
+    slate.assign(slots, slots + count);
+    slate_ids.clear();
+    slate_scores.clear();
+    for (int slot : slate) {
+        slate_ids.push_back(stores.business_id[slot]);
+        slate_scores.push_back(base_score(customer, stores, slot));
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef ARRIVAL_CONTEXT_H
+#define ARRIVAL_CONTEXT_H
+
+#include <vector>
+#include "Customer.h"
+#include "StoreTable.h"
+
+using namespace std;
+
+// Arrival Context
+// Everything the ranking step works out for one customer arrival, handed on
+// to the decision step and the metrics so nothing is ranked or scored twice.
+// The simulation keeps one context and reuses its buffers across arrivals.
+struct ArrivalContext {
+    // Stores the ranking scored (slots in catalog order) and the customer's
+    // base score for each, i.e. Customer::calculate_store_score
+    vector<int> candidates;
+    vector<float> candidate_scores;
+
+    // The slate shown to the customer, best first
+    vector<int> slate;           // slots
+    vector<int> slate_ids;       // business IDs
+    vector<float> slate_scores;  // base score of each slate entry
+
+    // Optional candidates supplied by the caller when they were retrieved
+    // ahead of time (batch ranking): the available slots within travel
+    // distance in catalog order, and their base scores if known (else null).
+    // preset_count is -1 when nothing is supplied. Not owned; reset() keeps them.
+    const int* preset_candidates;
+    const float* preset_scores;
+    int preset_count;
+
+    ArrivalContext();
+
+    // Clear all buffers (capacity is kept)
+    void reset();
+
+    // Base score for a slot: taken from the candidates when already known,
+    // computed otherwise
+    float base_score(const Customer& customer, const StoreTable& stores, int slot) const;
+
+    // Record the final slate and fill in its IDs and scores
+    void set_slate(const int* slots, int count, const Customer& customer, const StoreTable& stores);
+};
+
+#endif // ARRIVAL_CONTEXT_H
@@ -2,36 +2,63 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <ctime>
 #include <cctype>
 #include <iostream>
 
 using namespace std;
 
-// Initialize generator with a random seed
-ArrivalGenerator::ArrivalGenerator(unsigned seed) : rng(seed) {}
+// Initialize generator with a seed
+ArrivalGenerator::ArrivalGenerator(uint64_t seed)
+    : seed(seed), rng(seed), customers_from_csv(make_shared<vector<Customer>>()) {}
 
 // Initialize with a CSV file and seed
-ArrivalGenerator::ArrivalGenerator(const string& csv_path, unsigned seed)
-    : rng(seed) {
+ArrivalGenerator::ArrivalGenerator(const string& csv_path, uint64_t seed)
+    : seed(seed), rng(seed), customers_from_csv(make_shared<vector<Customer>>()) {
     load_customers_from_csv(csv_path);
 }
 
+void ArrivalGenerator::set_seed(uint64_t new_seed) {
+    seed = new_seed;
+    rng = RandomStream(seed);
+}
+
+// Draw one segment parameter: base + (rng() % range) / scale
+float ArrivalGenerator::draw(const SegmentDraw& d) {
+    return d.base + (rng() % d.range) / d.scale;
+}
+
 // Generate random arrival times for customers
-vector<Timestamp> ArrivalGenerator::generate_arrival_times(int num_customers) {
+vector<Timestamp> ArrivalGenerator::generate_arrival_times(int num_customers, int day) {
     vector<Timestamp> times;
-    uniform_int_distribution<int> hour_dist(8, 21); // 8 AM to 9 PM
-    uniform_int_distribution<int> min_dist(0, 59);
-
-    for (int i = 0; i < num_customers; i++) {
-        times.push_back(Timestamp(hour_dist(rng), min_dist(rng)));
+    times.reserve(max(num_customers, 0));
+    for (const Timestamp& time : stream_arrival_times(num_customers, day)) {
+        times.push_back(time);
     }
-
-    // Sort times so customers arrive in order
-    sort(times.begin(), times.end());
     return times;
 }
 
+// Arrivals already come out sorted, so nothing is buffered
+ArrivalStream ArrivalGenerator::stream_arrival_times(int num_customers, int day) const {
+    return ArrivalStream(num_customers, RandomStream(seed, StreamPurpose::ARRIVAL_TIMES, day),
+                         arrival_profile.for_day(day));
+}
+
+void ArrivalGenerator::set_customers(vector<Customer> customers) {
+    customers_from_csv = make_shared<vector<Customer>>(move(customers));
+}
+
+const vector<Customer>& ArrivalGenerator::get_customers() const {
+    return *customers_from_csv;
+}
+
+void ArrivalGenerator::set_arrival_profile(const WeeklyArrivalProfile& profile) {
+    arrival_profile = profile;
+}
+
+const WeeklyArrivalProfile& ArrivalGenerator::get_arrival_profile() const {
+    return arrival_profile;
+}
+
 // Load customer data from a CSV file
 bool ArrivalGenerator::load_customers_from_csv(const string& filename) {
     if (filename.empty()) {
@@ -137,12 +164,14 @@ bool ArrivalGenerator::load_customers_from_csv(const string& filename) {
         return false;
     }
 
-    // Read data rows
+    // Read data rows (appended to the templates already loaded)
+    vector<Customer> loaded(*customers_from_csv);
     int row_num = 1;
     while (getline(file, line)) {
         if (line.empty()) continue;
         
         row_num++;
+        rng = RandomStream(seed, StreamPurpose::CSV_FILL, 0, row_num);
         stringstream ss(line);
         vector<string> values;
         string val;
@@ -200,19 +229,15 @@ bool ArrivalGenerator::load_customers_from_csv(const string& filename) {
                 else segment = "premium";
             }
             
+            // Missing numeric columns are drawn from the segment's defaults
+            const SegmentGenerationParams& defaults = SEGMENT_CSV_DEFAULTS[(int)parse_segment(segment)];
+
             // Generate willingness_to_pay based on segment if missing
             float willingness_to_pay;
             if (wtp_idx != -1 && wtp_idx < (int)values.size() && !values[wtp_idx].empty()) {
                 willingness_to_pay = stof(values[wtp_idx]);
             } else {
-                // Generate based on segment
-                if (segment == "budget") {
-                    willingness_to_pay = 80.0f + (rng() % 40);  // 80-120 EGP
-                } else if (segment == "regular") {
-                    willingness_to_pay = 120.0f + (rng() % 60);  // 120-180 EGP
-                } else {  // premium
-                    willingness_to_pay = 180.0f + (rng() % 80);  // 180-260 EGP
-                }
+                willingness_to_pay = draw(defaults.willingness_to_pay);
             }
             
             // Generate weights based on segment if missing
@@ -221,37 +246,19 @@ bool ArrivalGenerator::load_customers_from_csv(const string& filename) {
             if (rating_w_idx != -1 && rating_w_idx < (int)values.size() && !values[rating_w_idx].empty()) {
                 rating_w = stof(values[rating_w_idx]);
             } else {
-                if (segment == "budget") {
-                    rating_w = 0.5f + (rng() % 100) / 200.0f;  // 0.5-1.0
-                } else if (segment == "regular") {
-                    rating_w = 1.0f + (rng() % 100) / 200.0f;  // 1.0-1.5
-                } else {  // premium
-                    rating_w = 1.5f + (rng() % 100) / 200.0f;  // 1.5-2.0
-                }
+                rating_w = draw(defaults.rating_w);
             }
             
             if (price_w_idx != -1 && price_w_idx < (int)values.size() && !values[price_w_idx].empty()) {
                 price_w = stof(values[price_w_idx]);
             } else {
-                if (segment == "budget") {
-                    price_w = 1.5f + (rng() % 100) / 200.0f;  // 1.5-2.0 (price sensitive)
-                } else if (segment == "regular") {
-                    price_w = 0.8f + (rng() % 80) / 200.0f;  // 0.8-1.2
-                } else {  // premium
-                    price_w = 0.3f + (rng() % 80) / 200.0f;  // 0.3-0.7 (less price sensitive)
-                }
+                price_w = draw(defaults.price_w);
             }
             
             if (novelty_w_idx != -1 && novelty_w_idx < (int)values.size() && !values[novelty_w_idx].empty()) {
                 novelty_w = stof(values[novelty_w_idx]);
             } else {
-                if (segment == "budget") {
-                    novelty_w = 0.2f + (rng() % 60) / 200.0f;  // 0.2-0.5
-                } else if (segment == "regular") {
-                    novelty_w = 0.4f + (rng() % 60) / 200.0f;  // 0.4-0.7
-                } else {  // premium
-                    novelty_w = 0.6f + (rng() % 80) / 200.0f;  // 0.6-1.0 (adventurous)
-                }
+                novelty_w = draw(defaults.novelty_w);
             }
             
             // Generate leaving_threshold based on segment if missing
@@ -259,13 +266,7 @@ bool ArrivalGenerator::load_customers_from_csv(const string& filename) {
             if (leaving_threshold_idx != -1 && leaving_threshold_idx < (int)values.size() && !values[leaving_threshold_idx].empty()) {
                 leaving_threshold = stof(values[leaving_threshold_idx]);
             } else {
-                if (segment == "budget") {
-                    leaving_threshold = 1.5f + (rng() % 20) / 20.0f;  // 1.5-2.5
-                } else if (segment == "regular") {
-                    leaving_threshold = 2.5f + (rng() % 20) / 20.0f;  // 2.5-3.5
-                } else {  // premium
-                    leaving_threshold = 3.5f + (rng() % 20) / 20.0f;  // 3.5-4.5
-                }
+                leaving_threshold = draw(defaults.leaving_threshold);
             }
             
             // Create customer with parsed/generated values
@@ -273,7 +274,7 @@ bool ArrivalGenerator::load_customers_from_csv(const string& filename) {
                       willingness_to_pay, rating_w, price_w, novelty_w, leaving_threshold);
             c.store_valuations = store_valuations;
             
-            customers_from_csv.push_back(c);
+            loaded.push_back(c);
             
         } catch (const exception& e) {
             cerr << "Warning: Error parsing row " << row_num << ": " << e.what() << ". Skipping." << endl;
@@ -282,8 +283,9 @@ bool ArrivalGenerator::load_customers_from_csv(const string& filename) {
     }
 
     file.close();
+    customers_from_csv = make_shared<vector<Customer>>(move(loaded));
     
-    cout << "Loaded " << customers_from_csv.size()
+    cout << "Loaded " << customers_from_csv->size()
               << " customers from " << filename << endl;
     if (!store_valuation_columns.empty()) {
         cout << "  Found " << store_valuation_columns.size() << " store valuation columns" << endl;
@@ -291,10 +293,10 @@ bool ArrivalGenerator::load_customers_from_csv(const string& filename) {
     
     // Count segments for verification
     int budget_count = 0, regular_count = 0, premium_count = 0;
-    for (const auto& c : customers_from_csv) {
-        if (c.segment == "budget") budget_count++;
-        else if (c.segment == "regular") regular_count++;
-        else if (c.segment == "premium") premium_count++;
+    for (const auto& c : *customers_from_csv) {
+        if (c.segment == CustomerSegment::BUDGET) budget_count++;
+        else if (c.segment == CustomerSegment::REGULAR) regular_count++;
+        else if (c.segment == CustomerSegment::PREMIUM) premium_count++;
     }
     cout << "  Segment distribution: Budget=" << budget_count 
               << ", Regular=" << regular_count 
@@ -305,53 +307,32 @@ bool ArrivalGenerator::load_customers_from_csv(const string& filename) {
 
 // Generate a singe customer (either from CSV pool or random)
 Customer ArrivalGenerator::generate_customer(int index, const vector<Restaurant>& restaurants) {
-    if (!customers_from_csv.empty()) {
+    if (!customers_from_csv->empty()) {
         // Recycle customers if we run out
-        int csv_index = index % customers_from_csv.size();
-        Customer c = customers_from_csv[csv_index];
+        int csv_index = index % customers_from_csv->size();
+        Customer c = (*customers_from_csv)[csv_index];
         c.id = index;
         return c;
     }
     
     // Fallback: Generate completely random customer
+    rng = RandomStream(seed, StreamPurpose::CUSTOMER_PROFILE, 0, index);
+    // Segments 0-2 are BUDGET, REGULAR, PREMIUM
     uniform_int_distribution<int> segment_dist(0, 2);
-    int seg = segment_dist(rng);
-
-    string segment;
-    float wtp;
-    float rating_w, price_w, novelty_w;
-    float leaving_thresh;
+    CustomerSegment seg = (CustomerSegment)segment_dist(rng);
+    const SegmentGenerationParams& params = SEGMENT_RANDOM_CUSTOMER[(int)seg];
 
-    if (seg == 0) {
-        segment = "budget";
-        wtp = 80.0f + (rng() % 40);
-        rating_w = 0.5f + (rng() % 100) / 200.0f;
-        price_w = 1.5f + (rng() % 100) / 200.0f;
-        novelty_w = 0.3f + (rng() % 100) / 200.0f;
-        leaving_thresh = 2.0f + (rng() % 30) / 10.0f;
-    }
-    else if (seg == 1) {
-        segment = "regular";
-        wtp = 120.0f + (rng() % 60);
-        rating_w = 1.0f + (rng() % 100) / 200.0f;
-        price_w = 1.0f + (rng() % 100) / 200.0f;
-        novelty_w = 0.5f + (rng() % 100) / 200.0f;
-        leaving_thresh = 3.0f + (rng() % 40) / 10.0f;
-    }
-    else {
-        segment = "premium";
-        wtp = 180.0f + (rng() % 80);
-        rating_w = 1.5f + (rng() % 100) / 200.0f;
-        price_w = 0.5f + (rng() % 100) / 200.0f;
-        novelty_w = 0.8f + (rng() % 100) / 200.0f;
-        leaving_thresh = 4.0f + (rng() % 40) / 10.0f;
-    }
+    float wtp = draw(params.willingness_to_pay);
+    float rating_w = draw(params.rating_w);
+    float price_w = draw(params.price_w);
+    float novelty_w = draw(params.novelty_w);
+    float leaving_thresh = draw(params.leaving_threshold);
 
     uniform_real_distribution<float> lon_dist(31.2f, 31.3f);
     uniform_real_distribution<float> lat_dist(30.0f, 30.1f);
     
     Customer customer(index, lon_dist(rng), lat_dist(rng), 
-                     "Customer_" + to_string(index), segment, 
+                     "Customer_" + to_string(index), segment_name(seg), 
                      wtp, rating_w, price_w, novelty_w, leaving_thresh);
     
     if (!restaurants.empty()) {
@@ -4,30 +4,56 @@
 #include <vector>
 #include <string>
 #include <random>
-#include <ctime>
+#include <memory>
 #include "Customer.h"
 #include "Timestamp.h"
 #include "Restaurant.h"
+#include "RandomStream.h"
+#include "ArrivalStream.h"
+#include "ArrivalProfile.h"
 
 using namespace std;
 
 // Arrival Generator
+// Every generated item draws from its own stream (see RandomStream), so
+// customer i or day d comes out the same whatever else was generated first.
 class ArrivalGenerator {
 private:
-    mt19937 rng; // Random number generator
-    vector<Customer> customers_from_csv;
+    uint64_t seed;
+    RandomStream rng; // stream of the item being generated
+    // Customer templates (CSV rows or a generated population); shared, since
+    // generators are copied per replication and populations can be large
+    shared_ptr<const vector<Customer>> customers_from_csv;
+    WeeklyArrivalProfile arrival_profile;
+
+    float draw(const SegmentDraw& d);
 
 public:
     // Constructors
-    ArrivalGenerator(unsigned seed = time(nullptr));
-    ArrivalGenerator(const string& csv_path, unsigned seed = time(nullptr));
+    ArrivalGenerator(uint64_t seed = DEFAULT_SIMULATION_SEED);
+    ArrivalGenerator(const string& csv_path, uint64_t seed = DEFAULT_SIMULATION_SEED);
+
+    // Generate arrival times for a day, in order, shaped by the day's
+    // intensity profile (flat 8:00-22:00 unless a profile is set)
+    vector<Timestamp> generate_arrival_times(int num_customers, int day = 0);
 
-    // Generate arrival times (8 AM - 9 PM)
-    vector<Timestamp> generate_arrival_times(int num_customers);
+    // The same times, produced one at a time without storing the day
+    ArrivalStream stream_arrival_times(int num_customers, int day = 0) const;
 
     // Load customers from CSV
     bool load_customers_from_csv(const string& filename);
 
+    // Replace the customer templates (e.g. with a synthetic population)
+    void set_customers(vector<Customer> customers);
+    const vector<Customer>& get_customers() const;
+
+    // Time-of-day intensity per weekday for the arrival times
+    void set_arrival_profile(const WeeklyArrivalProfile& profile);
+    const WeeklyArrivalProfile& get_arrival_profile() const;
+
+    // Switch to another seed; customers already loaded from CSV are kept
+    void set_seed(uint64_t new_seed);
+
     // Generate a customer
     Customer generate_customer(int index, const vector<Restaurant>& restaurants = vector<Restaurant>());
 };
@@ -0,0 +1,220 @@
+#include "ArrivalProfile.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+// Sort by start; false if segments are empty, overlap or carry no weight
+static bool sort_segments(vector<IntensitySegment>& segments) {
+    sort(segments.begin(), segments.end(),
+        [](const IntensitySegment& a, const IntensitySegment& b) { return a.start < b.start; });
+
+    double total = 0.0;
+    for (size_t i = 0; i < segments.size(); i++) {
+        const IntensitySegment& s = segments[i];
+        if (!(s.start < s.end) || s.weight < 0.0) return false;
+        if (i > 0 && s.start < segments[i - 1].end) return false;
+        total += s.weight;
+    }
+    return total > 0.0;
+}
+
+IntensityProfile::IntensityProfile() {
+    build_flat();
+}
+
+IntensityProfile::IntensityProfile(vector<IntensitySegment> segments) {
+    if (!sort_segments(segments)) {
+        build_flat();
+        return;
+    }
+
+    double total = 0.0;
+    for (size_t i = 0; i < segments.size(); i++) {
+        const IntensitySegment& s = segments[i];
+        int start = s.start.to_minutes(), end = s.end.to_minutes();
+
+        // A gap before this segment becomes a zero-weight segment
+        if (i > 0 && start > boundary.back()) {
+            boundary.push_back(start);
+            cumulative.push_back(total);
+        }
+        if (i == 0) {
+            boundary.push_back(start);
+            cumulative.push_back(0.0);
+        }
+        total += s.weight * (end - start);
+        boundary.push_back(end);
+        cumulative.push_back(total);
+    }
+
+    for (double& c : cumulative) {
+        c /= total;
+    }
+    cumulative.back() = 1.0;
+}
+
+void IntensityProfile::build_flat() {
+    boundary.assign(1, 8 * 60);
+    boundary.push_back(22 * 60);
+    cumulative.assign(1, 0.0);
+    cumulative.push_back(1.0);
+}
+
+int IntensityProfile::opening_minute() const {
+    return (int)boundary.front();
+}
+
+int IntensityProfile::closing_minute() const {
+    return (int)boundary.back();
+}
+
+double IntensityProfile::minute_at(double fraction, int& segment) const {
+    int last = (int)boundary.size() - 2;
+    segment = min(max(segment, 0), last);
+
+    // Zero-weight segments have equal cumulative ends and are stepped over
+    while (segment < last && cumulative[segment + 1] <= fraction) {
+        segment++;
+    }
+    double share = cumulative[segment + 1] - cumulative[segment];
+    double within = share > 0.0 ? (fraction - cumulative[segment]) / share : 0.0;
+    return boundary[segment] + within * (boundary[segment + 1] - boundary[segment]);
+}
+
+double IntensityProfile::peak_share_per_minute() const {
+    double peak = 0.0;
+    for (size_t i = 0; i + 1 < boundary.size(); i++) {
+        peak = max(peak, (cumulative[i + 1] - cumulative[i]) / (boundary[i + 1] - boundary[i]));
+    }
+    return peak;
+}
+
+WeeklyArrivalProfile::WeeklyArrivalProfile() {}
+
+const IntensityProfile& WeeklyArrivalProfile::for_day(int day) const {
+    return days[((day % 7) + 7) % 7];
+}
+
+void WeeklyArrivalProfile::set_day(int weekday, const IntensityProfile& profile) {
+    days[((weekday % 7) + 7) % 7] = profile;
+}
+
+WeeklyArrivalProfile WeeklyArrivalProfile::meal_peaks() {
+    // Weekdays: lunch rush and the after-work rush for end-of-day bags
+    vector<IntensitySegment> weekday = {
+        {Timestamp(8, 0), Timestamp(11, 30), 0.5},
+        {Timestamp(11, 30), Timestamp(12, 0), 1.2},
+        {Timestamp(12, 0), Timestamp(14, 0), 2.5},
+        {Timestamp(14, 0), Timestamp(17, 0), 0.7},
+        {Timestamp(17, 0), Timestamp(19, 0), 1.4},
+        {Timestamp(19, 0), Timestamp(21, 0), 2.8},
+        {Timestamp(21, 0), Timestamp(22, 0), 1.6}
+    };
+    // Weekends: slow morning, long lunch, busy evening
+    vector<IntensitySegment> weekend = {
+        {Timestamp(8, 0), Timestamp(11, 0), 0.3},
+        {Timestamp(11, 0), Timestamp(12, 30), 1.0},
+        {Timestamp(12, 30), Timestamp(15, 0), 2.2},
+        {Timestamp(15, 0), Timestamp(18, 0), 1.0},
+        {Timestamp(18, 0), Timestamp(21, 30), 2.4},
+        {Timestamp(21, 30), Timestamp(22, 0), 1.2}
+    };
+
+    WeeklyArrivalProfile profile;
+    for (int day = 0; day < 7; day++) {
+        profile.set_day(day, IntensityProfile(day < 5 ? weekday : weekend));
+    }
+    return profile;
+}
+
+// "H:MM" -> Timestamp; false on bad input
+static bool parse_time(const string& text, Timestamp& time) {
+    size_t colon = text.find(':');
+    if (colon == string::npos) return false;
+    int hour = atoi(text.substr(0, colon).c_str());
+    int minute = atoi(text.substr(colon + 1).c_str());
+    if (hour < 0 || hour > 24 || minute < 0 || minute > 59) return false;
+    if (hour == 24 && minute != 0) return false;
+    time = Timestamp(hour, minute);
+    return true;
+}
+
+// "0"-"6", "mon"-"sun" or "all" (-1); false on bad input
+static bool parse_weekday(string text, int& weekday) {
+    static const char* names[] = {"mon", "tue", "wed", "thu", "fri", "sat", "sun"};
+    transform(text.begin(), text.end(), text.begin(), ::tolower);
+    if (text == "all") {
+        weekday = -1;
+        return true;
+    }
+    for (int day = 0; day < 7; day++) {
+        if (text.size() >= 3 && text.compare(0, 3, names[day]) == 0) {
+            weekday = day;
+            return true;
+        }
+    }
+    if (text.size() == 1 && text[0] >= '0' && text[0] <= '6') {
+        weekday = text[0] - '0';
+        return true;
+    }
+    return false;
+}
+
+bool WeeklyArrivalProfile::load_from_csv(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Warning: Could not open arrival profile CSV file: " << filename << endl;
+        return false;
+    }
+
+    vector<IntensitySegment> segments[7];
+    string line;
+    getline(file, line);   // header
+    int line_number = 1;
+    while (getline(file, line)) {
+        line_number++;
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+
+        vector<string> fields;
+        stringstream ss(line);
+        string field;
+        while (getline(ss, field, ',')) {
+            field.erase(0, field.find_first_not_of(" \t"));
+            field.erase(field.find_last_not_of(" \t\r") + 1);
+            fields.push_back(field);
+        }
+
+        int weekday;
+        IntensitySegment segment;
+        if (fields.size() < 4 || !parse_weekday(fields[0], weekday) ||
+            !parse_time(fields[1], segment.start) || !parse_time(fields[2], segment.end)) {
+            cerr << "Warning: Bad arrival profile row " << line_number << ": " << line << endl;
+            return false;
+        }
+        segment.weight = atof(fields[3].c_str());
+
+        for (int day = 0; day < 7; day++) {
+            if (weekday == -1 || weekday == day) {
+                segments[day].push_back(segment);
+            }
+        }
+    }
+
+    for (int day = 0; day < 7; day++) {
+        if (!segments[day].empty() && !sort_segments(segments[day])) {
+            cerr << "Warning: Arrival profile for weekday " << day
+                 << " has overlapping or weightless segments" << endl;
+            return false;
+        }
+    }
+    for (int day = 0; day < 7; day++) {
+        if (!segments[day].empty()) {
+            days[day] = IntensityProfile(segments[day]);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef ARRIVAL_PROFILE_H
+#define ARRIVAL_PROFILE_H
+
+#include <vector>
+#include <string>
+#include "Timestamp.h"
+
+using namespace std;
+
+// Arrival Profile
+// Time-of-day arrival intensity as a piecewise-constant curve. Given a
+// day's customer count, arrivals of a non-homogeneous Poisson process are
+// independent draws with density proportional to the intensity, so the
+// arrival stream maps its ascending uniforms through the inverse of the
+// cumulative intensity. That is exact for a piecewise-constant curve and,
+// because the uniforms ascend, walks the segments once per day (no
+// thinning rejections).
+
+// One piece of the curve: relative intensity over [start, end)
+struct IntensitySegment {
+    Timestamp start;
+    Timestamp end;
+    double weight;
+};
+
+class IntensityProfile {
+public:
+    // Flat from 8:00 to 22:00
+    IntensityProfile();
+
+    // Segments in any order; gaps between them have zero intensity.
+    // Falls back to flat if the segments overlap or carry no weight.
+    explicit IntensityProfile(vector<IntensitySegment> segments);
+
+    int opening_minute() const;
+    int closing_minute() const;
+
+    // Minute of the day (fractional) by which the given fraction of the
+    // day's arrivals has come. segment is a cursor: start it at 0 and keep
+    // passing it back while fractions ascend.
+    double minute_at(double fraction, int& segment) const;
+
+    // Share of the day's arrivals expected in the busiest minute
+    double peak_share_per_minute() const;
+
+private:
+    vector<double> boundary;     // segment i covers [boundary[i], boundary[i + 1]) minutes
+    vector<double> cumulative;   // share of the day's intensity before boundary[i]
+
+    void build_flat();
+};
+
+// One intensity curve per weekday. Day d of a run uses weekday d % 7,
+// with day 0 taken as Monday.
+class WeeklyArrivalProfile {
+public:
+    // Flat 8:00-22:00 every day (the historical arrival model)
+    WeeklyArrivalProfile();
+
+    const IntensityProfile& for_day(int day) const;
+    void set_day(int weekday, const IntensityProfile& profile);
+
+    // Built-in curve with lunch and closing-time peaks (later, broader
+    // peaks at the weekend)
+    static WeeklyArrivalProfile meal_peaks();
+
+    // CSV with columns weekday,start,end,weight. weekday is 0-6, mon-sun or
+    // all; start and end are H:MM, with 24:00 the latest end. Weekdays
+    // without rows stay flat.
+    bool load_from_csv(const string& filename);
+
+private:
+    IntensityProfile days[7];
+};
+
+#endif // ARRIVAL_PROFILE_H
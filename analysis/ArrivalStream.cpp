@@ -0,0 +1,50 @@
+#include "ArrivalStream.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+ArrivalStream::ArrivalStream() : left(0), survivor(1.0), segment(0) {}
+
+ArrivalStream::ArrivalStream(int count, const RandomStream& rng, const IntensityProfile& profile)
+    : rng(rng), left(max(count, 0)), survivor(1.0), profile(profile), segment(0) {}
+
+bool ArrivalStream::done() const {
+    return left == 0;
+}
+
+int ArrivalStream::remaining() const {
+    return left;
+}
+
+Timestamp ArrivalStream::next() {
+    // The smallest of the remaining uniforms on [1 - survivor, 1)
+    survivor *= pow(rng.open_uniform(), 1.0 / left);
+    left--;
+
+    int minute = (int)profile.minute_at(1.0 - survivor, segment);
+    minute = min(max(minute, profile.opening_minute()), profile.closing_minute() - 1);
+    return Timestamp::from_seconds(minute * 60);
+}
+
+ArrivalStream::iterator ArrivalStream::begin() {
+    return iterator(this);
+}
+
+ArrivalStream::iterator ArrivalStream::end() {
+    return iterator();
+}
+
+ArrivalStream::iterator::iterator(ArrivalStream* stream) : stream(stream) {
+    ++*this;
+}
+
+ArrivalStream::iterator& ArrivalStream::iterator::operator++() {
+    if (stream && stream->done()) {
+        stream = nullptr;
+    }
+    if (stream) {
+        current = stream->next();
+    }
+    return *this;
+}
@@ -0,0 +1,67 @@
+#ifndef ARRIVAL_STREAM_H
+#define ARRIVAL_STREAM_H
+
+#include <iterator>
+#include <cstddef>
+#include "Timestamp.h"
+#include "RandomStream.h"
+#include "ArrivalProfile.h"
+
+using namespace std;
+
+// Arrival Stream
+// Emits a day's arrival times in ascending order, one at a time, with
+// O(1) memory and no sort. The times are the sorted values of count
+// independent draws from the day's intensity profile (minute resolution):
+// each next uniform is drawn as the minimum of the ones still to come,
+// x' = 1 - (1 - x) * V^(1/remaining) with V uniform in (0, 1), and mapped
+// to a time through the profile's inverse cumulative intensity.
+class ArrivalStream {
+public:
+    // Input iterator over the remaining arrivals
+    class iterator {
+    public:
+        typedef input_iterator_tag iterator_category;
+        typedef Timestamp value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Timestamp* pointer;
+        typedef const Timestamp& reference;
+
+        explicit iterator(ArrivalStream* stream = nullptr);
+        const Timestamp& operator*() const { return current; }
+        const Timestamp* operator->() const { return &current; }
+        iterator& operator++();
+        bool operator==(const iterator& other) const { return stream == other.stream; }
+        bool operator!=(const iterator& other) const { return stream != other.stream; }
+
+    private:
+        ArrivalStream* stream;   // null once past the last arrival
+        Timestamp current;
+    };
+
+    // Empty stream
+    ArrivalStream();
+
+    // count arrivals shaped by profile (flat 8:00-22:00 by default), drawn from rng
+    ArrivalStream(int count, const RandomStream& rng,
+                  const IntensityProfile& profile = IntensityProfile());
+
+    bool done() const;
+    int remaining() const;
+
+    // Next arrival time (call only while !done())
+    Timestamp next();
+
+    // Iterating consumes the stream
+    iterator begin();
+    iterator end();
+
+private:
+    RandomStream rng;
+    int left;            // arrivals not yet emitted
+    double survivor;     // 1 - position of the last arrival in the day
+    IntensityProfile profile;
+    int segment;         // profile cursor; only moves forward
+};
+
+#endif // ARRIVAL_STREAM_H
@@ -0,0 +1,183 @@
+#include "BatchRanking.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "ArrivalContext.h"
+#include "StoreScoring.h"
+#include "SoftmaxSampler.h"
+
+using namespace std;
+
+// Block extent as a fraction of the travel distance: blocks wider than
+// this share a neighbourhood so much larger than each customer's reach
+// that filtering it costs more than separate queries
+static const float BLOCK_EXTENT = 0.25f;
+
+// Slack on the shared radius so float rounding in the triangle inequality
+// never drops a store one of the block's customers can reach
+static const float SHARED_SLACK = 1.001f;
+
+// Baseline ranks by rating alone and never reads candidates
+static bool uses_candidates(RankingAlgorithm algorithm) {
+    return algorithm != RankingAlgorithm::BASELINE;
+}
+
+// Ziad reads only the candidate slots, not the customer's scores
+static bool uses_base_scores(RankingAlgorithm algorithm) {
+    return algorithm != RankingAlgorithm::BASELINE && algorithm != RankingAlgorithm::ZIAD;
+}
+
+// Rank every customer and hand each ranked context to visit, with the
+// customer's index
+static void rank_blocks(const vector<Customer>& customers, const MarketState& market_state,
+                        int n_displayed, RankingAlgorithm algorithm,
+                        const function<void(int, const ArrivalContext&)>& visit) {
+    const StoreTable& stores = market_state.get_store_table();
+    const SpatialIndex& index = market_state.get_spatial_index();
+    const SlotBitset& available = market_state.get_available_slots();
+    float radius = market_state.get_travel_distance();
+    int num_customers = (int)customers.size();
+
+    ArrivalContext context;
+    if (!uses_candidates(algorithm)) {
+        for (int c = 0; c < num_customers; c++) {
+            get_displayed_stores(customers[c], market_state, n_displayed, algorithm, context);
+            visit(c, context);
+        }
+        return;
+    }
+    bool scored = uses_base_scores(algorithm);
+
+    // Visit customers cell by cell so consecutive customers are neighbours
+    float cell = radius * BLOCK_EXTENT;
+    vector<pair<pair<long long, long long>, int>> order(num_customers);
+    for (int c = 0; c < num_customers; c++) {
+        order[c] = make_pair(make_pair((long long)floor(customers[c].latitude / cell),
+                                       (long long)floor(customers[c].longitude / cell)), c);
+    }
+    sort(order.begin(), order.end());
+
+    vector<int> shared;
+    vector<int> candidates;
+    vector<float> scores;
+    CustomerScoringParams params;
+
+    for (int begin = 0; begin < num_customers; ) {
+        // Grow the block while it stays within BLOCK_EXTENT on both axes
+        const Customer& first = customers[order[begin].second];
+        float min_lat = first.latitude, max_lat = first.latitude;
+        float min_lon = first.longitude, max_lon = first.longitude;
+        int end = begin + 1;
+        while (end < num_customers && end - begin < BATCH_BLOCK_CUSTOMERS) {
+            const Customer& next = customers[order[end].second];
+            float lo_lat = min(min_lat, next.latitude), hi_lat = max(max_lat, next.latitude);
+            float lo_lon = min(min_lon, next.longitude), hi_lon = max(max_lon, next.longitude);
+            if (hi_lat - lo_lat > cell || hi_lon - lo_lon > cell) break;
+            min_lat = lo_lat;
+            max_lat = hi_lat;
+            min_lon = lo_lon;
+            max_lon = hi_lon;
+            end++;
+        }
+
+        // A store within radius of a block customer is within radius plus
+        // half the block diagonal of the block centre
+        float center_lat = (min_lat + max_lat) / 2.0f;
+        float center_lon = (min_lon + max_lon) / 2.0f;
+        float half_diagonal = SpatialIndex::distance(min_lat, min_lon, max_lat, max_lon) / 2.0f;
+        shared.clear();
+        index.query_radius(center_lat, center_lon, (radius + half_diagonal) * SHARED_SLACK, shared);
+        size_t kept = 0;
+        for (int slot : shared) {
+            if (available.test(slot)) shared[kept++] = slot;
+        }
+        shared.resize(kept);
+        sort(shared.begin(), shared.end());
+
+        for (int i = begin; i < end; i++) {
+            const Customer& customer = customers[order[i].second];
+
+            // Same test as the spatial query, so the candidates are exactly
+            // the ones a single arrival would collect
+            candidates.clear();
+            for (int slot : shared) {
+                if (SpatialIndex::distance(customer.latitude, customer.longitude,
+                                           stores.latitude[slot], stores.longitude[slot]) <= radius) {
+                    candidates.push_back(slot);
+                }
+            }
+            if (scored) {
+                params.load(customer, stores);
+                scores.resize(candidates.size());
+                score_store_slots(params, stores, candidates.data(), (int)candidates.size(), scores.data());
+            }
+
+            context.preset_candidates = candidates.data();
+            context.preset_scores = scored ? scores.data() : nullptr;
+            context.preset_count = (int)candidates.size();
+            get_displayed_stores(customer, market_state, n_displayed, algorithm, context);
+            visit(order[i].second, context);
+        }
+        begin = end;
+    }
+}
+
+vector<vector<int>> rank_customer_batch(const vector<Customer>& customers,
+                                        const MarketState& market_state,
+                                        int n_displayed,
+                                        RankingAlgorithm algorithm) {
+    vector<vector<int>> slates(customers.size());
+    rank_blocks(customers, market_state, n_displayed, algorithm,
+                [&slates](int c, const ArrivalContext& context) {
+        slates[c] = context.slate_ids;
+    });
+    return slates;
+}
+
+vector<vector<int>> rank_customer_batch(const vector<Customer>& customers,
+                                        const MarketState& market_state,
+                                        int n_displayed,
+                                        RankingAlgorithm algorithm,
+                                        uint64_t seed,
+                                        int day,
+                                        vector<int>& choices,
+                                        float temperature) {
+    int num_customers = (int)customers.size();
+    int stride = max(n_displayed, 1);
+    vector<vector<int>> slates(num_customers);
+
+    // Row c of the tile holds customer c's valid options
+    vector<float> valid_scores(num_customers * (size_t)stride);
+    vector<int> valid_slate_index(num_customers * (size_t)stride);
+    vector<int> counts(num_customers, 0);
+    vector<int> valid_indices;
+    vector<float> row_scores;
+    rank_blocks(customers, market_state, n_displayed, algorithm,
+                [&](int c, const ArrivalContext& context) {
+        slates[c] = context.slate_ids;
+        if (CustomerDecisionSystem::find_valid_choices(customers[c], context.slate_ids, context.slate_scores,
+                                                       market_state, valid_indices, row_scores)) {
+            counts[c] = (int)row_scores.size();
+            copy(row_scores.begin(), row_scores.end(), valid_scores.begin() + (size_t)c * stride);
+            copy(valid_indices.begin(), valid_indices.end(), valid_slate_index.begin() + (size_t)c * stride);
+        }
+    });
+
+    // First draw of each customer's stream, as the decision step takes it
+    vector<float> uniforms(num_customers);
+    for (int c = 0; c < num_customers; c++) {
+        RandomStream rng(seed, StreamPurpose::STORE_CHOICE, day, customers[c].id);
+        uniforms[c] = rng.uniform();
+    }
+
+    vector<int> picked(num_customers);
+    sample_softmax_batch(valid_scores.data(), stride, counts.data(), num_customers,
+                         temperature, uniforms.data(), picked.data());
+    choices.assign(num_customers, -1);
+    for (int c = 0; c < num_customers; c++) {
+        if (picked[c] >= 0) {
+            choices[c] = slates[c][valid_slate_index[(size_t)c * stride + picked[c]]];
+        }
+    }
+    return slates;
+}
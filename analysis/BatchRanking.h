@@ -0,0 +1,48 @@
+#ifndef BATCH_RANKING_H
+#define BATCH_RANKING_H
+
+#include <vector>
+#include "Customer.h"
+#include "MarketState.h"
+#include "RankingAlgorithms.h"
+#include "CustomerDecisionSystem.h"
+
+using namespace std;
+
+// Batch Ranking
+// Ranks a block of customers against one frozen market snapshot, e.g. for
+// offline evaluation, shadow scoring or pre-computing slates between
+// inventory updates. Nothing in market_state is modified (no impressions
+// are recorded), so every customer sees exactly the same market and gets
+// the slate a single arrival would.
+//
+// Customers are visited in grid order and grouped into small blocks of
+// nearby customers. Each block fetches one shared neighbourhood from the
+// spatial index (filtered for availability and sorted once); each customer
+// then keeps the shared stores in its own reach, scores only those with
+// the vectorized kernels and is ranked from that candidate list.
+
+// Most customers per block
+const int BATCH_BLOCK_CUSTOMERS = 16;
+
+// slates[i] is the slate (business IDs, best first) for customers[i]
+vector<vector<int>> rank_customer_batch(const vector<Customer>& customers,
+                                        const MarketState& market_state,
+                                        int n_displayed,
+                                        RankingAlgorithm algorithm);
+
+// The same slates, plus each customer's store choice: choices[i] is the
+// business ID customers[i] would pick from their slate, or -1 if they would
+// leave. Choices are drawn for all customers in one sample_softmax_batch
+// call, from each customer's STORE_CHOICE stream for (seed, day), so they
+// match what select_store draws for that customer on this market.
+vector<vector<int>> rank_customer_batch(const vector<Customer>& customers,
+                                        const MarketState& market_state,
+                                        int n_displayed,
+                                        RankingAlgorithm algorithm,
+                                        uint64_t seed,
+                                        int day,
+                                        vector<int>& choices,
+                                        float temperature = DEFAULT_CHOICE_TEMPERATURE);
+
+#endif // BATCH_RANKING_H
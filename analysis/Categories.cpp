@@ -0,0 +1,39 @@
+#include "Categories.h"
+#include <vector>
+#include <mutex>
+
+using namespace std;
+
+// Function-local statics so the registry is ready before any
+// namespace-scope object that interns a category
+static mutex& registry_mutex() {
+    static mutex m;
+    return m;
+}
+
+static vector<string>& registry_names() {
+    static vector<string> names;
+    return names;
+}
+
+// Only a handful of business types exist, so a linear search is fine
+int intern_category(const string& name) {
+    lock_guard<mutex> lock(registry_mutex());
+    vector<string>& names = registry_names();
+    for (int i = 0; i < (int)names.size(); i++) {
+        if (names[i] == name) return i;
+    }
+    names.push_back(name);
+    return (int)names.size() - 1;
+}
+
+string category_name(int category) {
+    lock_guard<mutex> lock(registry_mutex());
+    const vector<string>& names = registry_names();
+    return (category >= 0 && category < (int)names.size()) ? names[category] : string();
+}
+
+int category_count() {
+    lock_guard<mutex> lock(registry_mutex());
+    return (int)registry_names().size();
+}
@@ -0,0 +1,23 @@
+#ifndef CATEGORIES_H
+#define CATEGORIES_H
+
+#include <string>
+
+using namespace std;
+
+// Store Categories
+// Business types are interned once into small dense ids so that customer
+// preferences and history can be plain vectors indexed by category. The
+// registry is process-wide and safe to use from several threads; ids are
+// never reused or renumbered.
+
+// Id for a category name, registering it on first use
+int intern_category(const string& name);
+
+// Name for an id returned by intern_category
+string category_name(int category);
+
+// Number of categories registered so far
+int category_count();
+
+#endif // CATEGORIES_H
@@ -1,12 +1,14 @@
 #include "Customer.h"
 #include "Restaurant.h"
+#include "StoreTable.h"
+#include "Categories.h"
 #include <algorithm>
 #include <cmath>
 
 using namespace std;
 
 // Distance threshold for pickup (approx 5.5km)
-extern const float MAX_TRAVEL_DISTANCE = 0.05f;
+const float MAX_TRAVEL_DISTANCE = 0.05f;
 
 // Calculate distance between two coordinate points
 static float calculate_distance(float lat1, float lon1, float lat2, float lon2) {
@@ -15,10 +17,6 @@ static float calculate_distance(float lat1, float lon1, float lat2, float lon2)
     return sqrt(dlat * dlat + dlon * dlon);
 }
 
-// Constructor for interaction history
-CustomerHistory::StoreInteraction::StoreInteraction() 
-    : reservations(0), successes(0), cancellations(0) {}
-
 // Constructor for overall history
 CustomerHistory::CustomerHistory() 
     : visits(0), reservations(0), successes(0), cancellations(0), last_reservation_time(0, 0) {}
@@ -27,22 +25,23 @@ CustomerHistory::CustomerHistory()
 Customer::Weights::Weights(float r, float p, float n)
     : rating_w(r), price_w(p), novelty_w(n) {}
 
+// Reservations recorded for a category
+int CustomerHistory::times_reserved(int category) const {
+    return (category >= 0 && category < (int)categories_reserved.size()) ? categories_reserved[category] : 0;
+}
+
 // Default constructor
 Customer::Customer() 
-    : id(0), customer_name("garry"), segment("regular"), willingness_to_pay(200.0f),
+    : id(0), customer_name("garry"), segment(CustomerSegment::REGULAR), willingness_to_pay(200.0f),
       loyalty(0.8f), leaving_threshold(5.0f), churned(false) {
-    category_preference["bakery"] = 1.0f;
-    category_preference["cafe"] = 1.0f;
-    category_preference["restaurant"] = 1.0f;
+    set_default_preferences();
 }
 
 // Constructor with ID and segment
 Customer::Customer(int customer_id, const string& seg)
-    : id(customer_id), segment(seg), willingness_to_pay(200.0f),
+    : id(customer_id), segment(parse_segment(seg)), willingness_to_pay(200.0f),
       loyalty(0.8f), leaving_threshold(3.0f), churned(false) {
-    category_preference["bakery"] = 1.0f;
-    category_preference["cafe"] = 1.0f;
-    category_preference["restaurant"] = 1.0f;
+    set_default_preferences();
 }
 
 // Full constructor
@@ -53,7 +52,7 @@ Customer::Customer(int id_, float lon_, float lat_, const string& name_,
     longitude = lon_;
     latitude = lat_;
     customer_name = name_;
-    segment = segment_;
+    segment = parse_segment(segment_);
     willingness_to_pay = wtp;
     weights.rating_w = rating_weight;
     weights.price_w = price_weight;
@@ -61,36 +60,63 @@ Customer::Customer(int id_, float lon_, float lat_, const string& name_,
     loyalty = 0.8f;
     leaving_threshold = leaving_thresh;
     churned = false;
-    category_preference["bakery"] = 1.0f;
-    category_preference["cafe"] = 1.0f;
-    category_preference["restaurant"] = 1.0f;
+    set_default_preferences();
+}
+
+// Every customer starts with the same liking for the three core types
+void Customer::set_default_preferences() {
+    static const int core_categories[] = {
+        intern_category("bakery"), intern_category("cafe"), intern_category("restaurant")
+    };
+    for (int category : core_categories) {
+        if (category >= (int)category_preference.size()) {
+            category_preference.resize(category + 1, 0.0f);
+        }
+        category_preference[category] = 1.0f;
+    }
+}
+
+float Customer::get_category_preference(int category) const {
+    return (category >= 0 && category < (int)category_preference.size()) ? category_preference[category] : 0.0f;
 }
 
 // Calculate score for a store based on preferences
-float Customer::calculate_store_score(const Restaurant& store) const {
+float Customer::calculate_store_score(const Restaurant& store, float max_distance) const {
+    return score_store(store.latitude, store.longitude, store.get_rating(),
+                       store.price_per_bag, store.category_id, max_distance);
+}
+
+// Same score, reading the columnar store table
+float Customer::calculate_store_score(const StoreTable& stores, int slot) const {
+    return score_store(stores.latitude[slot], stores.longitude[slot], stores.rating[slot],
+                       stores.price_per_bag[slot], stores.category[slot], stores.max_travel_distance);
+}
+
+float Customer::score_store(float store_lat, float store_lon, float rating,
+                            float price, int category, float max_distance) const {
     // Determine distance
-    float distance = calculate_distance(latitude, longitude, store.latitude, store.longitude);
+    float distance = calculate_distance(latitude, longitude, store_lat, store_lon);
     
     // Filter out stores that are too far
-    if (distance > MAX_TRAVEL_DISTANCE) {
+    if (distance > max_distance) {
         return -100.0f;
     }
     
     // Calculate component scores
-    float rating_score = weights.rating_w * store.get_rating();
-    float price_score = weights.price_w * (willingness_to_pay - store.price_per_bag) / willingness_to_pay;
+    float rating_score = weights.rating_w * rating;
+    float price_score = weights.price_w * (willingness_to_pay - price) / willingness_to_pay;
     
     // Novelty score (higher for new categories)
     float novelty_score = 0.0f;
-    auto it = history.categories_reserved.find(store.business_type);
-    if (it == history.categories_reserved.end()) {
+    int reserved = history.times_reserved(category);
+    if (reserved == 0) {
         novelty_score = weights.novelty_w * 1.0f;
     } else {
-        novelty_score = weights.novelty_w * (1.0f / (1.0f + it->second));
+        novelty_score = weights.novelty_w * (1.0f / (1.0f + reserved));
     }
     
     // Distance score: closer is better
-    float normalized_distance = distance / MAX_TRAVEL_DISTANCE;
+    float normalized_distance = distance / max_distance;
     float distance_score = (1.0f - normalized_distance) * 1.5f;
     
     return rating_score + price_score + novelty_score + distance_score;
@@ -106,7 +132,11 @@ void Customer::update_loyalty(bool was_cancelled) {
 }
 
 // Increase preference for a category
-void Customer::update_category_preference(const string& category) {
+void Customer::update_category_preference(int category) {
+    if (category < 0) return;
+    if (category >= (int)category_preference.size()) {
+        category_preference.resize(category + 1, 0.0f);
+    }
     category_preference[category] += 0.1f;
 }
 
@@ -116,24 +146,35 @@ void Customer::record_visit() {
 }
 
 // Record a reservation attempt
-void Customer::record_reservation_attempt(int store_id, const string& category, Timestamp time) {
+void Customer::record_reservation_attempt(int store_slot, int category, Timestamp time) {
     history.reservations++;
     history.last_reservation_time = time;
-    history.categories_reserved[category]++;
-    history.store_interactions[store_id].reservations++;
+    if (category >= 0) {
+        if (category >= (int)history.categories_reserved.size()) {
+            history.categories_reserved.resize(category + 1, 0);
+        }
+        history.categories_reserved[category]++;
+    }
+    if (store_slot >= 0) {
+        history.store_interactions[store_slot].reservations++;
+    }
 }
 
 // Record a successful purchase
-void Customer::record_reservation_success(int store_id, const string& category) {
+void Customer::record_reservation_success(int store_slot, int category) {
     history.successes++;
-    history.store_interactions[store_id].successes++;
+    if (store_slot >= 0) {
+        history.store_interactions[store_slot].successes++;
+    }
     update_category_preference(category);
 }
 
 // Record a cancellation
-void Customer::record_reservation_cancellation(int store_id) {
+void Customer::record_reservation_cancellation(int store_slot) {
     history.cancellations++;
-    history.store_interactions[store_id].cancellations++;
+    if (store_slot >= 0) {
+        history.store_interactions[store_slot].cancellations++;
+    }
     update_loyalty(true);
 }
 
@@ -3,12 +3,19 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include "Timestamp.h"
+#include "Segments.h"
+#include "StoreInteractionTable.h"
 
 using namespace std;
 
-// Forward declaration
+// Default pickup radius (defined in Customer.cpp)
+extern const float MAX_TRAVEL_DISTANCE;
+
+// Forward declarations
 class Restaurant;
+class StoreTable;
 
 // Customer History
 struct CustomerHistory {
@@ -18,18 +25,12 @@ struct CustomerHistory {
     int cancellations;
     Timestamp last_reservation_time;
     
-    // Category history
-    map<string, int> categories_reserved;
-
-    // Store interaction history
-    struct StoreInteraction {
-        int reservations;
-        int successes;
-        int cancellations;
+    // Category history: reservations per category id (missing ids are 0)
+    vector<int> categories_reserved;
+    int times_reserved(int category) const;
 
-        StoreInteraction();
-    };
-    map<int, StoreInteraction> store_interactions;
+    // Store interaction history, keyed by MarketState store slot
+    StoreInteractionTable store_interactions;
 
     CustomerHistory();
 };
@@ -41,7 +42,7 @@ public:
     float longitude;
     float latitude;
     string customer_name;
-    string segment;
+    CustomerSegment segment;
     float willingness_to_pay;
 
     // Decision weights
@@ -58,8 +59,9 @@ public:
     CustomerHistory history;
     bool churned;
 
-    // Preferences
-    map<string, float> category_preference;
+    // Preferences by category id (missing ids are 0)
+    vector<float> category_preference;
+    float get_category_preference(int category) const;
     
     // Store valuations
     map<int, float> store_valuations;
@@ -71,26 +73,35 @@ public:
              const string& segment_, float wtp, float rating_weight,
              float price_weight, float novelty_weight, float leaving_thresh);
 
-    // Calculate score for a store
-    float calculate_store_score(const Restaurant& store) const;
+    // Calculate score for a store (stores beyond max_distance score -100;
+    // the table version uses the table's travel distance)
+    float calculate_store_score(const Restaurant& store, float max_distance = MAX_TRAVEL_DISTANCE) const;
+    float calculate_store_score(const StoreTable& stores, int slot) const;
 
     // Update loyalty
     void update_loyalty(bool was_cancelled);
 
-    // Update category preference
-    void update_category_preference(const string& category);
+    // Update category preference (no-op for category -1)
+    void update_category_preference(int category);
 
     // Record visit
     void record_visit();
 
-    // Record reservation attempt
-    void record_reservation_attempt(int store_id, const string& category, Timestamp time);
+    // Record reservation attempt (store_slot -1: totals only)
+    void record_reservation_attempt(int store_slot, int category, Timestamp time);
 
     // Record successful reservation
-    void record_reservation_success(int store_id, const string& category);
+    void record_reservation_success(int store_slot, int category);
 
     // Record cancellation
-    void record_reservation_cancellation(int store_id);
+    void record_reservation_cancellation(int store_slot);
+
+private:
+    // Shared scoring math for both store representations
+    float score_store(float store_lat, float store_lon, float rating,
+                      float price, int category, float max_distance) const;
+
+    void set_default_preferences();
 };
 
 #endif // CUSTOMER_H
@@ -1,24 +1,51 @@
 #include "CustomerDecisionSystem.h"
 #include "RankingAlgorithms.h"
+#include "SoftmaxSampler.h"
+#include "PhaseTimer.h"
 #include <algorithm>
-#include <ctime>
-#include <random>
-#include <cmath>
 
 using namespace std;
 
+// Per-thread buffers for select_store, reused across arrivals
+struct ChoiceScratch {
+    vector<float> adjusted_scores;
+    vector<int> valid_indices;
+    vector<float> valid_scores;
+};
+
+static ChoiceScratch& choice_scratch() {
+    static thread_local ChoiceScratch scratch;
+    return scratch;
+}
+
 // Process a customer arrival event
 // Returns the selected store ID, or -1 if no store was selected
 int CustomerDecisionSystem::process_customer_arrival(Customer& customer,
                                                       MarketState& market_state,
                                                       int n_displayed,
-                                                      RankingAlgorithm algorithm) {
+                                                      RankingAlgorithm algorithm,
+                                                      uint64_t seed,
+                                                      int day) {
+    ArrivalContext context;
+    get_displayed_stores(customer, market_state, n_displayed, algorithm, context);
+    RandomStream rng(seed, StreamPurpose::STORE_CHOICE, day, customer.id);
+    return process_customer_arrival(customer, market_state, context, rng);
+}
+
+// The slate and the customer's base scores come from the ranking step
+int CustomerDecisionSystem::process_customer_arrival(Customer& customer,
+                                                      MarketState& market_state,
+                                                      const ArrivalContext& context,
+                                                      RandomStream& rng,
+                                                      float temperature) {
     customer.record_visit();
-    vector<int> displayed = get_displayed_stores(customer, market_state, n_displayed, algorithm);
+    const vector<int>& displayed = context.slate_ids;
     
-    // Track impressions for fairness algorithm
-    for (int store_id : displayed) {
-        market_state.impression_counts[store_id]++;
+    // Track impressions for fairness algorithm; every store the ranking
+    // weighed counts toward Harmony's average
+    market_state.track_ranked_stores(context.candidates);
+    for (int slot : context.slate) {
+        market_state.record_impression(slot);
     }
 
     // Customer leaves if no stores are shown
@@ -27,11 +54,8 @@ int CustomerDecisionSystem::process_customer_arrival(Customer& customer,
         return -1;
     }
 
-    // Calculate customer's score for each displayed store
-    vector<float> scores = calculate_store_scores(customer, displayed, market_state);
-    
     // Customer selects a store based on scores and probabilities
-    int selected = select_store(customer, displayed, scores, market_state);
+    int selected = select_store(customer, displayed, context.slate_scores, market_state, rng, temperature);
 
     if (selected == -1) {
         customer.churned = true; // Customer leaves platform
@@ -58,7 +82,7 @@ vector<float> CustomerDecisionSystem::calculate_store_scores(
     for (int store_id : displayed_store_ids) {
         const Restaurant* store = market_state.get_restaurant(store_id);
         if (store) {
-            float score = customer.calculate_store_score(*store);
+            float score = customer.calculate_store_score(*store, market_state.get_travel_distance());
             scores.push_back(score);
         } else {
             scores.push_back(-100.0f);  // Invalid store
@@ -67,12 +91,16 @@ vector<float> CustomerDecisionSystem::calculate_store_scores(
     return scores;
 }
 
-// Select a store from the displayed options
-int CustomerDecisionSystem::select_store(const Customer& customer,
-                                         const vector<int>& displayed_store_ids,
-                                         const vector<float>& scores,
-                                         const MarketState& market_state) {
-    if (scores.empty()) return -1;
+// Filter the displayed options down to the ones the customer would take
+bool CustomerDecisionSystem::find_valid_choices(const Customer& customer,
+                                                const vector<int>& displayed_store_ids,
+                                                const vector<float>& scores,
+                                                const MarketState& market_state,
+                                                vector<int>& valid_indices,
+                                                vector<float>& valid_scores) {
+    valid_indices.clear();
+    valid_scores.clear();
+    if (scores.empty()) return false;
 
     // Determine the minimum score required to make a purchase
     float base_threshold = customer.leaving_threshold;
@@ -82,39 +110,35 @@ int CustomerDecisionSystem::select_store(const Customer& customer,
     // If best option is too poor, customer leaves
     float max_score = *max_element(scores.begin(), scores.end());
     if (max_score < threshold) {
-        return -1;
+        return false;
     }
 
     // Adjust scores based on history and inventory safety
-    vector<float> adjusted_scores = scores;
+    ChoiceScratch& scratch = choice_scratch();
+    vector<float>& adjusted_scores = scratch.adjusted_scores;
+    adjusted_scores.assign(scores.begin(), scores.end());
     for (size_t i = 0; i < displayed_store_ids.size(); i++) {
-        int store_id = displayed_store_ids[i];
+        int slot = market_state.get_restaurant_slot(displayed_store_ids[i]);
+        if (slot < 0) continue;
         
         // History adjustment (boost successful past stores, penalize cancellations)
-        auto it = customer.history.store_interactions.find(store_id);
-        if (it != customer.history.store_interactions.end()) {
-            const auto& interaction = it->second;
-            if (interaction.reservations > 0) {
-                float success_rate = (float)interaction.successes / interaction.reservations;
-                adjusted_scores[i] += success_rate * 1.5f;
-                if (interaction.cancellations > 0) {
-                    float cancel_rate = (float)interaction.cancellations / interaction.reservations;
-                    adjusted_scores[i] -= cancel_rate * 2.0f;
-                }
+        const StoreInteraction* interaction = customer.history.store_interactions.find(slot);
+        if (interaction && interaction->reservations > 0) {
+            float success_rate = (float)interaction->successes / interaction->reservations;
+            adjusted_scores[i] += success_rate * 1.5f;
+            if (interaction->cancellations > 0) {
+                float cancel_rate = (float)interaction->cancellations / interaction->reservations;
+                adjusted_scores[i] -= cancel_rate * 2.0f;
             }
         }
         
         // Inventory safety bonus: customers prefer stores that likely have stock
-        const Restaurant* store = market_state.get_restaurant(store_id);
-        if (store) {
-            float inventory_safety = min(1.0f, (float)store->estimated_bags / 12.0f);
-            adjusted_scores[i] += inventory_safety * 0.3f;
-        }
+        const Restaurant& store = market_state.restaurant_at(slot);
+        float inventory_safety = min(1.0f, (float)store.estimated_bags / 12.0f);
+        adjusted_scores[i] += inventory_safety * 0.3f;
     }
 
     // Filter valid options (meeting threshold and distance check)
-    vector<int> valid_indices;
-    vector<float> valid_scores;
     for (size_t i = 0; i < adjusted_scores.size(); i++) {
         // Score < -50 means too far
         if (adjusted_scores[i] >= threshold && adjusted_scores[i] > -50.0f) {
@@ -122,13 +146,27 @@ int CustomerDecisionSystem::select_store(const Customer& customer,
             valid_scores.push_back(adjusted_scores[i]);
         }
     }
-    
-    if (valid_scores.empty()) {
+    return !valid_scores.empty();
+}
+
+// Select a store from the displayed options
+int CustomerDecisionSystem::select_store(const Customer& customer,
+                                         const vector<int>& displayed_store_ids,
+                                         const vector<float>& scores,
+                                         const MarketState& market_state,
+                                         RandomStream& rng,
+                                         float temperature) {
+    ChoiceScratch& scratch = choice_scratch();
+    vector<int>& valid_indices = scratch.valid_indices;
+    vector<float>& valid_scores = scratch.valid_scores;
+    if (!find_valid_choices(customer, displayed_store_ids, scores, market_state,
+                            valid_indices, valid_scores)) {
         return -1;
     }
     
     // Choose probabilistically among valid options
-    return probabilistic_select(displayed_store_ids, adjusted_scores, valid_indices, valid_scores);
+    return probabilistic_select(displayed_store_ids, scratch.adjusted_scores, valid_indices, valid_scores,
+                                rng, temperature);
 }
 
 // Probabilistic selection using Softmax
@@ -136,54 +174,27 @@ int CustomerDecisionSystem::probabilistic_select(
     const vector<int>& store_ids,
     const vector<float>& all_scores,
     const vector<int>& valid_indices,
-    const vector<float>& valid_scores) {
-    
-    static mt19937 rng(time(nullptr));
-    
-    float min_score = *min_element(valid_scores.begin(), valid_scores.end());
-    float temperature = 2.0f; // Controls randomness (higher = more random)
-    
-    // Calculate Softmax probabilities
-    vector<float> probabilities;
-    float sum_exp = 0.0f;
-    
-    for (float score : valid_scores) {
-        float shifted_score = score - min_score + 1.0f;
-        float exp_score = exp(shifted_score / temperature);
-        probabilities.push_back(exp_score);
-        sum_exp += exp_score;
-    }
-    
-    for (float& prob : probabilities) {
-        prob /= sum_exp;
-    }
+    const vector<float>& valid_scores,
+    RandomStream& rng,
+    float temperature) {
     
     // Weighted random choice
-    uniform_real_distribution<float> dist(0.0f, 1.0f);
-    float random_val = dist(rng);
-    float cumulative = 0.0f;
-    
-    for (size_t i = 0; i < probabilities.size(); i++) {
-        cumulative += probabilities[i];
-        if (random_val <= cumulative) {
-            return store_ids[valid_indices[i]];
-        }
-    }
-    
-    // Fallback
-    return store_ids[valid_indices.back()];
+    int choice = sample_softmax(valid_scores.data(), (int)valid_scores.size(), temperature, rng.uniform());
+    return store_ids[valid_indices[choice]];
 }
 
 // Create a reservation
 bool CustomerDecisionSystem::create_reservation(Customer& customer,
                                                 int restaurant_id,
                                                 MarketState& market_state) {
-    Restaurant* restaurant = market_state.get_restaurant(restaurant_id);
+    PHASE_SCOPE(SimPhase::RESERVATION);
+    int slot = market_state.get_restaurant_slot(restaurant_id);
     
     // Check if store can accept
-    if (!restaurant || !restaurant->can_accept_reservation()) {
+    if (slot < 0 || !market_state.restaurant_at(slot).can_accept_reservation()) {
         return false;
     }
+    Restaurant* restaurant = &market_state.restaurant_at(slot);
 
     // Create reservation object
     Reservation res(market_state.next_reservation_id++,
@@ -192,12 +203,13 @@ bool CustomerDecisionSystem::create_reservation(Customer& customer,
                     market_state.current_time);
 
     // Update customer history
-    customer.record_reservation_attempt(restaurant_id,
-                                        restaurant->business_type,
+    customer.record_reservation_attempt(slot,
+                                        restaurant->category_id,
                                         market_state.current_time);
 
     // Update store state
     restaurant->reserved_count++;
+    market_state.refresh_store(slot);
     market_state.reservations.push_back(res);
 
     return true;
@@ -5,17 +5,31 @@
 #include "Customer.h"
 #include "MarketState.h"
 #include "RankingAlgorithms.h"
+#include "RandomStream.h"
 
 using namespace std;
 
+// Softmax temperature for store choice (higher = more random)
+const float DEFAULT_CHOICE_TEMPERATURE = 2.0f;
+
 // Customer Decision System
 class CustomerDecisionSystem {
 public:
-    // Main entry point
+    // Main entry point: ranks, then draws the store choice from the
+    // customer's stream for the given run seed and day
     static int process_customer_arrival(Customer& customer,
                                         MarketState& market_state,
                                         int n_displayed,
-                                        RankingAlgorithm algorithm = RankingAlgorithm::BASELINE);
+                                        RankingAlgorithm algorithm,
+                                        uint64_t seed,
+                                        int day);
+
+    // Decide on a slate that has already been ranked into the context
+    static int process_customer_arrival(Customer& customer,
+                                        MarketState& market_state,
+                                        const ArrivalContext& context,
+                                        RandomStream& rng,
+                                        float temperature = DEFAULT_CHOICE_TEMPERATURE);
 
     // Calculate scores
     static vector<float> calculate_store_scores(
@@ -23,18 +37,32 @@ public:
         const vector<int>& displayed_store_ids,
         const MarketState& market_state);
 
+    // The slate entries the customer would consider: indexes into the slate
+    // and their history- and inventory-adjusted scores. False (the customer
+    // leaves) when nothing on the slate clears their threshold.
+    static bool find_valid_choices(const Customer& customer,
+                                   const vector<int>& displayed_store_ids,
+                                   const vector<float>& scores,
+                                   const MarketState& market_state,
+                                   vector<int>& valid_indices,
+                                   vector<float>& valid_scores);
+
     // Select store
     static int select_store(const Customer& customer,
                             const vector<int>& displayed_store_ids,
                             const vector<float>& scores,
-                            const MarketState& market_state);
+                            const MarketState& market_state,
+                            RandomStream& rng,
+                            float temperature = DEFAULT_CHOICE_TEMPERATURE);
 
-    // Probabilistic selection (softmax-like)
+    // Probabilistic selection (softmax over the valid scores)
     static int probabilistic_select(
         const vector<int>& store_ids,
         const vector<float>& all_scores,
         const vector<int>& valid_indices,
-        const vector<float>& valid_scores);
+        const vector<float>& valid_scores,
+        RandomStream& rng,
+        float temperature = DEFAULT_CHOICE_TEMPERATURE);
 
     // Create reservation
     static bool create_reservation(Customer& customer,
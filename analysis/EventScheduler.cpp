@@ -0,0 +1,106 @@
+#include "EventScheduler.h"
+#include <algorithm>
+
+using namespace std;
+
+EventTime to_event_time(const Timestamp& time) {
+    return time.to_seconds();
+}
+
+Timestamp to_timestamp(EventTime time) {
+    return Timestamp::from_seconds((int)time);
+}
+
+// Four children per node: half the depth of a binary heap, and a node's
+// children share a cache line or two, which matters with millions queued
+static const size_t HEAP_ARITY = 4;
+
+// Close of trading runs after everything else due at the same time, so an
+// arrival at the closing second is served before the day is settled
+static int same_time_rank(EventType type) {
+    return type == EventType::DAY_END ? 1 : 0;
+}
+
+static bool runs_before(const Event& a, const Event& b) {
+    if (a.time != b.time) return a.time < b.time;
+    int rank_a = same_time_rank(a.type), rank_b = same_time_rank(b.type);
+    if (rank_a != rank_b) return rank_a < rank_b;
+    return a.sequence < b.sequence;
+}
+
+EventScheduler::EventScheduler()
+    : next_sequence(0), current_time(0), processed_count(0) {}
+
+void EventScheduler::schedule(EventTime time, EventType type, int subject, int value) {
+    Event event;
+    event.time = max(time, current_time);
+    event.sequence = next_sequence++;
+    event.type = type;
+    event.subject = subject;
+    event.value = value;
+
+    // Sift up: move parents down until the event's place is found
+    size_t pos = heap.size();
+    heap.push_back(event);
+    while (pos > 0) {
+        size_t parent = (pos - 1) / HEAP_ARITY;
+        if (!runs_before(event, heap[parent])) break;
+        heap[pos] = heap[parent];
+        pos = parent;
+    }
+    heap[pos] = event;
+}
+
+bool EventScheduler::pop(Event& event) {
+    if (heap.empty()) return false;
+    event = heap[0];
+    Event last = heap.back();
+    heap.pop_back();
+
+    // Sift the last event down from the root
+    size_t n = heap.size();
+    size_t pos = 0;
+    while (true) {
+        size_t first = pos * HEAP_ARITY + 1;
+        if (first >= n) break;
+        size_t end = min(first + HEAP_ARITY, n);
+        size_t best = first;
+        for (size_t child = first + 1; child < end; child++) {
+            if (runs_before(heap[child], heap[best])) best = child;
+        }
+        if (!runs_before(heap[best], last)) break;
+        heap[pos] = heap[best];
+        pos = best;
+    }
+    if (n > 0) heap[pos] = last;
+
+    current_time = event.time;
+    processed_count++;
+    return true;
+}
+
+bool EventScheduler::empty() const {
+    return heap.empty();
+}
+
+size_t EventScheduler::pending() const {
+    return heap.size();
+}
+
+EventTime EventScheduler::now() const {
+    return current_time;
+}
+
+uint64_t EventScheduler::processed() const {
+    return processed_count;
+}
+
+void EventScheduler::reset(EventTime time) {
+    heap.clear();
+    next_sequence = 0;
+    current_time = time;
+}
+
+void EventScheduler::reserve(size_t count) {
+    heap.reserve(count);
+}
@@ -0,0 +1,73 @@
+#ifndef EVENT_SCHEDULER_H
+#define EVENT_SCHEDULER_H
+
+#include <vector>
+#include <cstdint>
+#include "Timestamp.h"
+
+using namespace std;
+
+// Event Scheduler
+// Discrete-event core of the day simulation. Events are small plain
+// records kept in a 4-ary min-heap on (time, sequence): the earliest
+// event runs first and events at the same time run in the order they were
+// scheduled, except that DAY_END waits for every other event due at its
+// time. A run is fully deterministic. The heap keeps its capacity
+// across days, so steady-state scheduling does not allocate.
+
+// Simulated time in seconds since midnight
+typedef int64_t EventTime;
+
+EventTime to_event_time(const Timestamp& time);
+Timestamp to_timestamp(EventTime time);
+
+enum class EventType {
+    ARRIVAL,            // subject = arrival index
+    INVENTORY_REVEAL,   // subject = store slot; the store learns its actual bags
+    PICKUP,             // subject = reservation index, value = bags handed over
+    CANCELLATION,       // subject = reservation index
+    DAY_END             // close of trading
+};
+
+struct Event {
+    EventTime time;
+    uint64_t sequence;
+    EventType type;
+    int subject;
+    int value;
+};
+
+class EventScheduler {
+public:
+    EventScheduler();
+
+    // Queue an event. Events never run in the past: an earlier time is
+    // moved up to the current time.
+    void schedule(EventTime time, EventType type, int subject = 0, int value = 0);
+
+    // Remove the next event into event and advance the clock; false when empty
+    bool pop(Event& event);
+
+    bool empty() const;
+    size_t pending() const;
+
+    // Time of the event last popped
+    EventTime now() const;
+
+    // Events popped since construction
+    uint64_t processed() const;
+
+    // Drop pending events and restart the clock at time
+    void reset(EventTime time = 0);
+
+    // Room for count pending events without reallocating
+    void reserve(size_t count);
+
+private:
+    vector<Event> heap;
+    uint64_t next_sequence;
+    EventTime current_time;
+    uint64_t processed_count;
+};
+
+#endif // EVENT_SCHEDULER_H
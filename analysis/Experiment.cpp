@@ -0,0 +1,72 @@
+#include "Experiment.h"
+#include "SimulationEngine.h"
+
+using namespace std;
+
+ScenarioConfig::ScenarioConfig()
+    : days(7), customers_per_day(100), n_displayed(5), travel_distance(MAX_TRAVEL_DISTANCE),
+      shard_threads(1) {}
+
+const vector<pair<string, RankingAlgorithm>>& ranking_algorithms() {
+    static const vector<pair<string, RankingAlgorithm>> algorithms = {
+        {"BASELINE", RankingAlgorithm::BASELINE},
+        {"SAMA", RankingAlgorithm::SAMA},
+        {"ANDREW", RankingAlgorithm::ANDREW},
+        {"AMER", RankingAlgorithm::AMER},
+        {"ZIAD", RankingAlgorithm::ZIAD},
+        {"HARMONY", RankingAlgorithm::HARMONY}
+    };
+    return algorithms;
+}
+
+SharedInputs generate_shared_inputs(ArrivalGenerator generator, uint64_t seed,
+                                    const vector<Restaurant>& restaurants,
+                                    const ScenarioConfig& config) {
+    generator.set_seed(seed);
+    SharedInputs inputs;
+
+    // Customer Pool (Account for all days + churn)
+    for (int i = 0; i < config.customers_per_day * 2; i++) {
+        inputs.customer_pool.push_back(generator.generate_customer(i, restaurants));
+    }
+
+    // Arrival Times (one schedule per day)
+    for (int day = 0; day < config.days; day++) {
+        inputs.arrival_times.push_back(generator.generate_arrival_times(config.customers_per_day, day));
+    }
+    return inputs;
+}
+
+SimulationMetrics run_algorithm(const string& algo_name, RankingAlgorithm algorithm, uint64_t seed,
+                                const ScenarioConfig& config,
+                                const vector<Restaurant>& restaurants, const SharedInputs& inputs,
+                                ostream* log, ostream* csv, PhaseTimes* phase_times) {
+    ostream discard(nullptr);
+    ostream& out = log ? *log : discard;
+
+    out << "\n" << string(100, '=') << "\n";
+    out << "SIMULATION: " << algo_name << " ALGORITHM\n";
+    out << string(100, '=') << "\n";
+
+    SimulationEngine engine(config.n_displayed, "", algorithm, seed);
+    engine.set_travel_distance(config.travel_distance);
+    engine.set_shard_threads(config.shard_threads);
+    engine.initialize(restaurants);
+    engine.set_output_stream(&out);
+
+    // Inject shared data
+    engine.set_customer_pool(inputs.customer_pool);
+    engine.set_arrival_times(inputs.arrival_times);
+
+    engine.run_multi_day_simulation(config.days, config.customers_per_day);
+
+    // Log results
+    out << "\n" << string(100, '=') << "\n";
+    out << algo_name << " ALGORITHM RESULTS\n";
+    out << string(100, '=') << "\n";
+    engine.get_metrics().print_summary_to_stream(out);
+
+    if (csv) engine.export_results(*csv);
+    if (phase_times) *phase_times = engine.get_phase_times();
+    return engine.get_metrics();
+}
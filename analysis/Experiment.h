@@ -0,0 +1,56 @@
+#ifndef EXPERIMENT_H
+#define EXPERIMENT_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <iostream>
+#include "Customer.h"
+#include "Restaurant.h"
+#include "Timestamp.h"
+#include "Metrics.h"
+#include "ArrivalGenerator.h"
+#include "RankingAlgorithms.h"
+#include "PhaseTimer.h"
+
+using namespace std;
+
+// Experiment
+// Building blocks shared by the algorithm comparison, the replication mode
+// and the parameter sweep: the scenario shape, the inputs every algorithm
+// of one seed shares, and a single engine run.
+
+// Scenario shape (defaults: 7 days, 100 customers/day, 5 stores shown)
+struct ScenarioConfig {
+    int days;
+    int customers_per_day;
+    int n_displayed;
+    float travel_distance;
+    int shard_threads;       // region shards per day (1 = sequential)
+
+    ScenarioConfig();
+};
+
+// Customers and arrivals shared by every algorithm in one replication
+struct SharedInputs {
+    vector<Customer> customer_pool;
+    vector<vector<Timestamp>> arrival_times;
+};
+
+// Ranking algorithms in report order
+const vector<pair<string, RankingAlgorithm>>& ranking_algorithms();
+
+// Pool of 2 x customers_per_day customers (room for churn) and one arrival
+// schedule per day, drawn from the generator's streams under seed
+SharedInputs generate_shared_inputs(ArrivalGenerator generator, uint64_t seed,
+                                    const vector<Restaurant>& restaurants,
+                                    const ScenarioConfig& config);
+
+// One engine run. log and csv may be null when the output is not kept;
+// phase_times, when given, receives the run's phase breakdown.
+SimulationMetrics run_algorithm(const string& algo_name, RankingAlgorithm algorithm, uint64_t seed,
+                                const ScenarioConfig& config,
+                                const vector<Restaurant>& restaurants, const SharedInputs& inputs,
+                                ostream* log, ostream* csv, PhaseTimes* phase_times = nullptr);
+
+#endif // EXPERIMENT_H
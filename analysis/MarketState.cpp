@@ -1,35 +1,289 @@
 #include "MarketState.h"
+#include <algorithm>
 
 using namespace std;
 
 // Constructor initializes time to 8:00 AM
-MarketState::MarketState() : current_time(8, 0), next_reservation_id(1) {}
+MarketState::MarketState()
+    : current_time(8, 0), next_reservation_id(1),
+      id_index(make_shared<StoreIdIndex>()),
+      spatial_index(make_shared<SpatialIndex>()),
+      travel_distance(MAX_TRAVEL_DISTANCE),
+      total_unsold_bags(0), stores_with_unsold_bags(0),
+      total_impressions(0), tracked_stores(0) {}
+
+// Replace the catalog and index it
+void MarketState::set_restaurants(const vector<Restaurant>& stores) {
+    restaurants = stores;
+    rebuild_store_index();
+}
+
+// IDs may run this far past the store count before the flat table gives
+// way to a hash map
+static const int SPARSE_ID_FACTOR = 4;
+static const int SPARSE_ID_SLACK = 1024;
+
+// Build the id -> slot table
+// Store IDs are usually small positive integers (CSV row IDs), so a flat
+// vector sized to the largest ID is both compact and O(1) to probe. IDs
+// from elsewhere (e.g. hashed or external keys) can be huge, and then a
+// hash map keeps the table proportional to the catalog.
+void MarketState::rebuild_store_index() {
+    int max_id = -1;
+    for (const auto& r : restaurants) {
+        max_id = max(max_id, r.business_id);
+    }
+
+    int store_count = (int)restaurants.size();
+    bool sparse = (long long)max_id > (long long)store_count * SPARSE_ID_FACTOR + SPARSE_ID_SLACK;
+    shared_ptr<StoreIdIndex> ids = make_shared<StoreIdIndex>();
+    ids->slot_by_id.assign(sparse ? 0 : max_id + 1, -1);
+    if (sparse) {
+        ids->sparse_slot_by_id.reserve(store_count);
+    }
+    for (int slot = 0; slot < store_count; slot++) {
+        int id = restaurants[slot].business_id;
+        if (id < 0) continue;
+        if (sparse) {
+            ids->sparse_slot_by_id.insert(make_pair(id, slot));
+        } else if (ids->slot_by_id[id] == -1) {
+            ids->slot_by_id[id] = slot;
+        }
+    }
+    id_index = ids;
+
+    // Rating index
+    int n = (int)restaurants.size();
+    rating_order.resize(n);
+    for (int slot = 0; slot < n; slot++) {
+        rating_order[slot] = slot;
+    }
+    sort(rating_order.begin(), rating_order.end(),
+        [this](int a, int b) { return rates_higher(a, b); });
+
+    rating_rank.resize(n);
+    for (int rank = 0; rank < n; rank++) {
+        rating_rank[rating_order[rank]] = rank;
+    }
+
+    store_table.build(restaurants);
+    store_table.max_travel_distance = travel_distance;
+    build_spatial_index();
+
+    available_slots.reset(n);
+    total_unsold_bags = 0;
+    stores_with_unsold_bags = 0;
+    for (int slot = 0; slot < n; slot++) {
+        available_slots.assign(slot, store_table.can_accept_reservation(slot));
+        add_unsold(slot, +1);
+    }
+
+    // Slots are renumbered, so impression history starts over
+    reset_impressions();
+}
+
+const StoreTable& MarketState::get_store_table() const {
+    return store_table;
+}
+
+const SpatialIndex& MarketState::get_spatial_index() const {
+    return *spatial_index;
+}
+
+// Grid cells are sized to the radius, so the index is rebuilt with it
+void MarketState::set_travel_distance(float distance) {
+    travel_distance = distance;
+    store_table.max_travel_distance = distance;
+    build_spatial_index();
+}
+
+// A fresh grid, so copies still holding the old one are unaffected
+void MarketState::build_spatial_index() {
+    shared_ptr<SpatialIndex> index = make_shared<SpatialIndex>();
+    index->build(store_table, travel_distance);
+    spatial_index = index;
+}
+
+void MarketState::copy_stores_from(const MarketState& other) {
+    restaurants = other.restaurants;
+    id_index = other.id_index;
+    rating_order = other.rating_order;
+    rating_rank = other.rating_rank;
+    store_table = other.store_table;
+    spatial_index = other.spatial_index;
+    travel_distance = other.travel_distance;
+    available_slots = other.available_slots;
+    total_unsold_bags = other.total_unsold_bags;
+    stores_with_unsold_bags = other.stores_with_unsold_bags;
+    reset_impressions();
+}
+
+float MarketState::get_travel_distance() const {
+    return travel_distance;
+}
+
+// Propagate a store's mutable fields to every derived index
+void MarketState::refresh_store(int slot) {
+    const Restaurant& r = restaurants[slot];
+    bool rating_changed = store_table.rating[slot] != r.get_rating();
+    add_unsold(slot, -1);
+    store_table.refresh(slot, r);
+    add_unsold(slot, +1);
+    available_slots.assign(slot, store_table.can_accept_reservation(slot));
+    if (rating_changed) {
+        update_rating_order(slot);
+    }
+}
+
+// Add (sign = +1) or remove (sign = -1) a store's unsold bags from the totals
+void MarketState::add_unsold(int slot, int sign) {
+    int unsold = store_table.unsold_bags(slot);
+    if (unsold > 0) {
+        total_unsold_bags += sign * unsold;
+        stores_with_unsold_bags += sign;
+    }
+}
+
+int MarketState::get_total_unsold_bags() const {
+    return total_unsold_bags;
+}
+
+int MarketState::get_stores_with_unsold_bags() const {
+    return stores_with_unsold_bags;
+}
+
+void MarketState::track_impressions(int slot) {
+    if (!impression_tracked[slot]) {
+        impression_tracked[slot] = 1;
+        tracked_stores++;
+    }
+}
+
+void MarketState::record_impression(int slot) {
+    track_impressions(slot);
+    impression_counts[slot]++;
+    total_impressions++;
+}
+
+void MarketState::track_ranked_stores(const vector<int>& slots) {
+    for (int slot : slots) {
+        track_impressions(slot);
+    }
+}
+
+int MarketState::get_impressions(int slot) const {
+    return impression_counts[slot];
+}
+
+float MarketState::get_average_impressions() const {
+    return tracked_stores > 0 ? (float)total_impressions / tracked_stores : 1.0f;
+}
+
+void MarketState::reset_impressions() {
+    impression_counts.assign(restaurants.size(), 0);
+    impression_tracked.assign(restaurants.size(), 0);
+    total_impressions = 0;
+    tracked_stores = 0;
+}
+
+void MarketState::add_impressions(int slot, int count) {
+    if (count <= 0) return;
+    track_impressions(slot);
+    impression_counts[slot] += count;
+    total_impressions += count;
+}
+
+// Strict ordering for the rating index
+bool MarketState::rates_higher(int slot_a, int slot_b) const {
+    float ra = restaurants[slot_a].get_rating();
+    float rb = restaurants[slot_b].get_rating();
+    if (ra != rb) return ra > rb;
+    return slot_a < slot_b;
+}
+
+const vector<int>& MarketState::get_rating_order() const {
+    return rating_order;
+}
+
+// Ratings move in small steps (+0.01 / -0.05), so the store only needs to
+// shift a few positions; insertion-style moves keep this near O(1).
+void MarketState::update_rating_order(int slot) {
+    int rank = rating_rank[slot];
+
+    while (rank > 0 && rates_higher(slot, rating_order[rank - 1])) {
+        rating_order[rank] = rating_order[rank - 1];
+        rating_rank[rating_order[rank]] = rank;
+        rank--;
+    }
+    while (rank + 1 < (int)rating_order.size() && rates_higher(rating_order[rank + 1], slot)) {
+        rating_order[rank] = rating_order[rank + 1];
+        rating_rank[rating_order[rank]] = rank;
+        rank++;
+    }
+
+    rating_order[rank] = slot;
+    rating_rank[slot] = rank;
+}
+
 
 // Get IDs of all stores that can accept reservations
 vector<int> MarketState::get_available_restaurant_ids() const {
     vector<int> available;
-    for (const auto& restaurant : restaurants) {
-        if (restaurant.can_accept_reservation()) {
-            available.push_back(restaurant.business_id);
-        }
+    available.reserve(available_slots.count());
+    for (int slot : available_slots) {
+        available.push_back(store_table.business_id[slot]);
     }
     return available;
 }
 
+// Get slots of all stores that can accept reservations (catalog order)
+vector<int> MarketState::get_available_restaurant_slots() const {
+    vector<int> available;
+    available.reserve(available_slots.count());
+    for (int slot : available_slots) {
+        available.push_back(slot);
+    }
+    return available;
+}
+
+const SlotBitset& MarketState::get_available_slots() const {
+    return available_slots;
+}
+
+// Translate a store ID to its slot
+int MarketState::get_restaurant_slot(int id) const {
+    const StoreIdIndex& ids = *id_index;
+    if (!ids.sparse_slot_by_id.empty()) {
+        auto it = ids.sparse_slot_by_id.find(id);
+        return it == ids.sparse_slot_by_id.end() ? -1 : it->second;
+    }
+    if (id < 0 || id >= (int)ids.slot_by_id.size()) return -1;
+    return ids.slot_by_id[id];
+}
+
+int MarketState::get_restaurant_count() const {
+    return (int)restaurants.size();
+}
+
 // Get non-const pointer to a store by ID
 Restaurant* MarketState::get_restaurant(int id) {
-    for (auto& r : restaurants) {
-        if (r.business_id == id) return &r;
-    }
-    return nullptr;
+    int slot = get_restaurant_slot(id);
+    return slot >= 0 ? &restaurants[slot] : nullptr;
 }
 
 // Get const pointer to a store by ID
 const Restaurant* MarketState::get_restaurant(int id) const {
-    for (const auto& r : restaurants) {
-        if (r.business_id == id) return &r;
-    }
-    return nullptr;
+    int slot = get_restaurant_slot(id);
+    return slot >= 0 ? &restaurants[slot] : nullptr;
+}
+
+// Get a store by slot
+Restaurant& MarketState::restaurant_at(int slot) {
+    return restaurants[slot];
+}
+
+const Restaurant& MarketState::restaurant_at(int slot) const {
+    return restaurants[slot];
 }
 
 // Get pointer to a customer by ID
@@ -37,4 +291,3 @@ Customer* MarketState::get_customer(int id) {
     auto it = customers.find(id);
     return (it != customers.end()) ? &(it->second) : nullptr;
 }
-
@@ -3,14 +3,22 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <memory>
 #include "Restaurant.h"
 #include "Customer.h"
 #include "Reservation.h"
 #include "Timestamp.h"
+#include "StoreTable.h"
+#include "SpatialIndex.h"
+#include "SlotBitset.h"
 
 using namespace std;
 
 // Market State
+// Stores are addressed either by business_id or by slot (their position in
+// the restaurants vector). Slots are dense and stable until the catalog is
+// replaced, so hot paths work on slots and translate to IDs only at the edges.
 class MarketState {
 public:
     vector<Restaurant> restaurants;
@@ -18,19 +26,109 @@ public:
     vector<Reservation> reservations;
     Timestamp current_time;
     int next_reservation_id;
-    map<int, int> impression_counts;
 
     // Constructor
     MarketState();
 
+    // Replace the store catalog and rebuild the lookup index
+    void set_restaurants(const vector<Restaurant>& stores);
+
+    // Rebuild the id -> slot index (call after editing restaurants directly)
+    void rebuild_store_index();
+
+    // Take another market's stores and their state, but none of its
+    // customers or reservations, for a private replay of part of a day (a
+    // region shard). The id table and spatial grid never change with store
+    // state, so they are shared rather than rebuilt; impressions start at 0.
+    void copy_stores_from(const MarketState& other);
+
     // Get restaurants with inventory
     vector<int> get_available_restaurant_ids() const;
+    vector<int> get_available_restaurant_slots() const;
+
+    // Live set of slots that can accept a reservation (no allocation)
+    const SlotBitset& get_available_slots() const;
+
+    // Slot lookup (-1 if the ID is unknown)
+    int get_restaurant_slot(int id) const;
+    int get_restaurant_count() const;
+
+    // Slots ordered by rating (highest first, ties by slot)
+    const vector<int>& get_rating_order() const;
+
+    // Columnar view of the hot scoring fields, indexed by slot
+    const StoreTable& get_store_table() const;
+
+    // Grid over store coordinates for travel-distance queries
+    const SpatialIndex& get_spatial_index() const;
+
+    // Pickup radius: stores farther from a customer are out of reach.
+    // Defaults to MAX_TRAVEL_DISTANCE; changing it re-grids the index.
+    void set_travel_distance(float distance);
+    float get_travel_distance() const;
+
+    // Call after mutating a store's rating, reservations or inventory flag
+    // so the derived indexes (columns, rating order, availability) stay in sync
+    void refresh_store(int slot);
+
+    // Market-wide unsold inventory, kept current by refresh_store
+    int get_total_unsold_bags() const;
+    int get_stores_with_unsold_bags() const;
+
+    // Impressions per store (slot-indexed). A store is tracked once it has
+    // been shown or ranked for an arrival, as the original impression map
+    // added an entry on every lookup the ranking made.
+    void record_impression(int slot);
+    void track_ranked_stores(const vector<int>& slots);
+    int get_impressions(int slot) const;
+    // Mean over tracked stores (1 if none are tracked)
+    float get_average_impressions() const;
+    void reset_impressions();
+    // Add impressions counted on another copy of the market (a region shard)
+    void add_impressions(int slot, int count);
+
 
     // Helpers
     Restaurant* get_restaurant(int id);
     const Restaurant* get_restaurant(int id) const;
+    Restaurant& restaurant_at(int slot);
+    const Restaurant& restaurant_at(int slot) const;
     Customer* get_customer(int id);
+
+private:
+    // Dense id -> slot table, -1 for IDs not in the catalog. Catalogs with
+    // IDs far beyond their store count use the hash map instead.
+    struct StoreIdIndex {
+        vector<int> slot_by_id;
+        unordered_map<int, int> sparse_slot_by_id;
+    };
+
+    // Rating index: rating_order[rank] = slot, rating_rank[slot] = rank
+    vector<int> rating_order;
+    vector<int> rating_rank;
+
+    StoreTable store_table;
+
+    // Read-only once built; copies of the market share them
+    shared_ptr<const StoreIdIndex> id_index;
+    shared_ptr<const SpatialIndex> spatial_index;
+    float travel_distance;
+    SlotBitset available_slots;
+
+    // Running aggregates
+    int total_unsold_bags;
+    int stores_with_unsold_bags;
+    vector<int> impression_counts;
+    long long total_impressions;
+    vector<char> impression_tracked;
+    int tracked_stores;
+
+    void add_unsold(int slot, int sign);
+    void build_spatial_index();
+    void track_impressions(int slot);
+
+    bool rates_higher(int slot_a, int slot_b) const;
+    void update_rating_order(int slot);
 };
 
 #endif // MARKETSTATE_H
-
@@ -119,6 +119,15 @@ void MetricsCollector::log_confirmation(const Reservation& res, int bags_receive
     metrics.total_bags_sold += bags_received;
 }
 
+// Add a shard's arrival counters
+void MetricsCollector::merge_arrivals(const SimulationMetrics& shard) {
+    metrics.total_customer_arrivals += shard.total_customer_arrivals;
+    metrics.customers_who_left += shard.customers_who_left;
+    for (const auto& pair : shard.times_displayed_per_store) {
+        metrics.times_displayed_per_store[pair.first] += pair.second;
+    }
+}
+
 // Calculate daily totals with accurate waste logic
 void MetricsCollector::log_end_of_day(const MarketState& market_state) {
     metrics.total_bags_sold = 0;
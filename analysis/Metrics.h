@@ -63,6 +63,10 @@ public:
     // Log confirmation
     void log_confirmation(const Reservation& res, int bags_received = 1);
 
+    // Add the arrival counters (arrivals, displays, customers who left)
+    // collected by a region shard; end-of-day totals are computed after
+    void merge_arrivals(const SimulationMetrics& shard);
+
     // Log end of day
     void log_end_of_day(const MarketState& market_state);
 
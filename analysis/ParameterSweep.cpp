@@ -0,0 +1,193 @@
+#include "ParameterSweep.h"
+#include "ThreadPool.h"
+#include "ReplicationStats.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+using namespace std;
+
+SweepSpec::SweepSpec() : replications(1), base_seed(DEFAULT_SIMULATION_SEED) {
+    ScenarioConfig defaults;
+    shard_threads = defaults.shard_threads;
+    days.push_back(defaults.days);
+    customers_per_day.push_back(defaults.customers_per_day);
+    n_displayed.push_back(defaults.n_displayed);
+    travel_distances.push_back(defaults.travel_distance);
+    for (int a = 0; a < (int)ranking_algorithms().size(); a++) {
+        algorithms.push_back(a);
+    }
+}
+
+int SweepSpec::job_count() const {
+    return (int)(days.size() * customers_per_day.size() * n_displayed.size() *
+                 travel_distances.size() * algorithms.size()) * replications;
+}
+
+vector<SweepJob> expand_sweep(const SweepSpec& spec) {
+    vector<SweepJob> jobs;
+    jobs.reserve(spec.job_count());
+    for (int days : spec.days)
+    for (int customers : spec.customers_per_day)
+    for (int n_displayed : spec.n_displayed)
+    for (float distance : spec.travel_distances)
+    for (int algorithm : spec.algorithms)
+    for (int r = 0; r < spec.replications; r++) {
+        SweepJob job;
+        job.index = (int)jobs.size();
+        job.config.days = days;
+        job.config.customers_per_day = customers;
+        job.config.n_displayed = n_displayed;
+        job.config.travel_distance = distance;
+        job.config.shard_threads = spec.shard_threads;
+        job.algorithm = algorithm;
+        job.replication = r;
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+static vector<string> split(const string& text, char separator) {
+    vector<string> parts;
+    stringstream ss(text);
+    string part;
+    while (getline(ss, part, separator)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+// Parse a whole token as a number (no trailing characters)
+static bool parse_number(const string& token, double& value) {
+    if (token.empty()) return false;
+    char* end = nullptr;
+    value = strtod(token.c_str(), &end);
+    return *end == '\0';
+}
+
+// Shared by the int and float parsers; values are start + i * step so
+// long float ranges do not drift
+static bool parse_values(const string& text, vector<double>& values) {
+    values.clear();
+    if (text.find(':') != string::npos) {
+        vector<string> parts = split(text, ':');
+        double first, last, step = 1.0;
+        if (parts.size() < 2 || parts.size() > 3) return false;
+        if (!parse_number(parts[0], first) || !parse_number(parts[1], last)) return false;
+        if (parts.size() == 3 && !parse_number(parts[2], step)) return false;
+        if (step <= 0.0 || last < first) return false;
+        double tolerance = step * 1e-6;
+        for (int i = 0; first + i * step <= last + tolerance; i++) {
+            values.push_back(first + i * step);
+        }
+        return true;
+    }
+    for (const string& part : split(text, ',')) {
+        double value;
+        if (!parse_number(part, value)) return false;
+        values.push_back(value);
+    }
+    return !values.empty();
+}
+
+bool parse_int_values(const string& text, vector<int>& values) {
+    vector<double> parsed;
+    if (!parse_values(text, parsed)) return false;
+    values.clear();
+    for (double v : parsed) {
+        if (v != floor(v)) return false;
+        values.push_back((int)v);
+    }
+    return true;
+}
+
+bool parse_float_values(const string& text, vector<float>& values) {
+    vector<double> parsed;
+    if (!parse_values(text, parsed)) return false;
+    values.assign(parsed.begin(), parsed.end());
+    return true;
+}
+
+bool parse_algorithm_list(const string& text, vector<int>& algorithms) {
+    const vector<pair<string, RankingAlgorithm>>& known = ranking_algorithms();
+    algorithms.clear();
+    if (text == "all") {
+        for (int a = 0; a < (int)known.size(); a++) algorithms.push_back(a);
+        return true;
+    }
+    for (string name : split(text, ',')) {
+        transform(name.begin(), name.end(), name.begin(), ::toupper);
+        int found = -1;
+        for (int a = 0; a < (int)known.size(); a++) {
+            if (known[a].first == name) found = a;
+        }
+        if (found == -1) return false;
+        algorithms.push_back(found);
+    }
+    return !algorithms.empty();
+}
+
+static void write_header(ostream& out) {
+    out << "job,days,customers_per_day,n_displayed,travel_distance,algorithm,replication,seed";
+    for (const auto& metric : reported_metrics()) {
+        out << "," << metric.key;
+    }
+    out << ",elapsed_ms\n";
+}
+
+static string format_row(const SweepJob& job, uint64_t seed, const SimulationMetrics& metrics, double elapsed_ms) {
+    ostringstream row;
+    row << job.index << "," << job.config.days << "," << job.config.customers_per_day << ","
+        << job.config.n_displayed << "," << job.config.travel_distance << ","
+        << ranking_algorithms()[job.algorithm].first << "," << job.replication << "," << seed;
+    for (const auto& metric : reported_metrics()) {
+        row << "," << fixed << setprecision(metric.precision) << metric.value(metrics);
+    }
+    row << "," << fixed << setprecision(1) << elapsed_ms << "\n";
+    return row.str();
+}
+
+int run_sweep(const SweepSpec& spec, const vector<Restaurant>& restaurants,
+              const ArrivalGenerator& generator, ostream& out, int threads) {
+    vector<SweepJob> jobs = expand_sweep(spec);
+
+    // Longest jobs first; stealing then fills the gaps with the short ones
+    vector<int> order(jobs.size());
+    for (int i = 0; i < (int)order.size(); i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&jobs](int a, int b) {
+        const ScenarioConfig& ca = jobs[a].config;
+        const ScenarioConfig& cb = jobs[b].config;
+        return (long long)ca.days * ca.customers_per_day > (long long)cb.days * cb.customers_per_day;
+    });
+
+    write_header(out);
+    out.flush();
+
+    mutex out_mutex;
+    ThreadPool pool(threads);
+    for (int i : order) {
+        pool.submit([&, i]() {
+            const SweepJob& job = jobs[i];
+            uint64_t seed = spec.base_seed + job.replication;
+            const pair<string, RankingAlgorithm>& algorithm = ranking_algorithms()[job.algorithm];
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            SharedInputs inputs = generate_shared_inputs(generator, seed, restaurants, job.config);
+            SimulationMetrics metrics = run_algorithm(algorithm.first, algorithm.second, seed, job.config,
+                                                      restaurants, inputs, nullptr, nullptr);
+            double elapsed_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+            string row = format_row(job, seed, metrics, elapsed_ms);
+            lock_guard<mutex> lock(out_mutex);
+            out << row;
+            out.flush();
+        });
+    }
+    pool.wait();
+    return (int)jobs.size();
+}
@@ -0,0 +1,54 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include "Experiment.h"
+
+using namespace std;
+
+// Parameter Sweep
+// Expands value lists for days, customers per day, n_displayed, travel
+// distance and algorithm (x replications) into a job grid, runs every job
+// on the work-stealing ThreadPool and streams one CSV row per finished job.
+// Rows arrive in completion order; the job column gives the grid position,
+// and a job's numbers depend only on its parameters and seed.
+
+struct SweepSpec {
+    vector<int> days;
+    vector<int> customers_per_day;
+    vector<int> n_displayed;
+    vector<float> travel_distances;
+    vector<int> algorithms;        // indexes into ranking_algorithms()
+    int replications;
+    uint64_t base_seed;            // replication r runs with base_seed + r
+    int shard_threads;             // region shards per day in every run
+
+    // Single-point grid: the default scenario, all algorithms, one seed
+    SweepSpec();
+
+    int job_count() const;
+};
+
+struct SweepJob {
+    int index;
+    ScenarioConfig config;
+    int algorithm;
+    int replication;
+};
+
+// Grid in row-major order (days outermost, replication innermost)
+vector<SweepJob> expand_sweep(const SweepSpec& spec);
+
+// Value lists: "a", "a,b,c" or "first:last[:step]" (step defaults to 1)
+bool parse_int_values(const string& text, vector<int>& values);
+bool parse_float_values(const string& text, vector<float>& values);
+// Comma-separated algorithm names, or "all"
+bool parse_algorithm_list(const string& text, vector<int>& algorithms);
+
+// Run the grid; returns the number of jobs written to out
+int run_sweep(const SweepSpec& spec, const vector<Restaurant>& restaurants,
+              const ArrivalGenerator& generator, ostream& out, int threads = 0);
+
+#endif // PARAMETER_SWEEP_H
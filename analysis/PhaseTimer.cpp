@@ -0,0 +1,163 @@
+#include "PhaseTimer.h"
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace std;
+
+static const char* PHASE_NAMES[NUM_SIM_PHASES] = {
+    "arrival generation",
+    "ranking",
+    "customer decision",
+    "reservation",
+    "settlement",
+    "metrics",
+    "log output"
+};
+
+// Active recorder's times and innermost open phase, per thread
+static thread_local PhaseTimes* current_times = nullptr;
+static thread_local PhaseScope* current_scope = nullptr;
+
+static double wall_clock() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// CPU time of the calling thread only, so concurrent runs do not mix
+static double thread_cpu_clock() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (double)(k.QuadPart + u.QuadPart) * 1e-7;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+const char* phase_name(SimPhase phase) {
+    return PHASE_NAMES[(int)phase];
+}
+
+bool phase_timing_enabled() {
+#ifdef SIM_PHASE_TIMING
+    return true;
+#else
+    return false;
+#endif
+}
+
+PhaseTimes::PhaseTimes() : run_wall_seconds(0.0), run_cpu_seconds(0.0) {
+    for (int p = 0; p < NUM_SIM_PHASES; p++) {
+        wall_seconds[p] = 0.0;
+        cpu_seconds[p] = 0.0;
+        entries[p] = 0;
+    }
+}
+
+void PhaseTimes::add(const PhaseTimes& other) {
+    for (int p = 0; p < NUM_SIM_PHASES; p++) {
+        wall_seconds[p] += other.wall_seconds[p];
+        cpu_seconds[p] += other.cpu_seconds[p];
+        entries[p] += other.entries[p];
+    }
+}
+
+double PhaseTimes::phase_wall_seconds() const {
+    double total = 0.0;
+    for (int p = 0; p < NUM_SIM_PHASES; p++) total += wall_seconds[p];
+    return total;
+}
+
+double PhaseTimes::phase_cpu_seconds() const {
+    double total = 0.0;
+    for (int p = 0; p < NUM_SIM_PHASES; p++) total += cpu_seconds[p];
+    return total;
+}
+
+// A recorder starts a fresh phase stack; scopes opened before it (e.g. on
+// a thread that runs a shard task inline) resume when it closes
+PhaseRecorder::PhaseRecorder(PhaseTimes& t)
+    : times(&t), previous_times(current_times), previous_scope(current_scope),
+      nested(current_times == &t), wall_start(0.0), cpu_start(0.0) {
+    if (!nested) {
+        wall_start = wall_clock();
+        cpu_start = thread_cpu_clock();
+        current_scope = nullptr;
+    }
+    current_times = times;
+}
+
+PhaseRecorder::~PhaseRecorder() {
+    if (!nested) {
+        times->run_wall_seconds += wall_clock() - wall_start;
+        times->run_cpu_seconds += thread_cpu_clock() - cpu_start;
+        current_scope = previous_scope;
+    }
+    current_times = previous_times;
+}
+
+PhaseScope::PhaseScope(SimPhase p)
+    : times(current_times), parent(current_scope), phase((int)p),
+      wall_start(0.0), cpu_start(0.0), nested_wall(0.0), nested_cpu(0.0) {
+    if (!times) return;
+    current_scope = this;
+    wall_start = wall_clock();
+    cpu_start = thread_cpu_clock();
+}
+
+PhaseScope::~PhaseScope() {
+    if (!times) return;
+    double wall = wall_clock() - wall_start;
+    double cpu = thread_cpu_clock() - cpu_start;
+    times->wall_seconds[phase] += wall - nested_wall;
+    times->cpu_seconds[phase] += cpu - nested_cpu;
+    times->entries[phase]++;
+    if (parent) {
+        parent->nested_wall += wall;
+        parent->nested_cpu += cpu;
+    }
+    current_scope = parent;
+}
+
+void write_phase_table(ostream& out, const PhaseTimes& times) {
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    double run_wall = max(times.run_wall_seconds, 1e-12);
+
+    out << left << setw(22) << "Phase" << right << setw(12) << "Wall ms" << setw(12) << "CPU ms"
+        << setw(9) << "Share" << setw(12) << "Entries" << "\n";
+    out << string(67, '-') << "\n";
+    out << fixed;
+    for (int p = 0; p < NUM_SIM_PHASES; p++) {
+        out << left << setw(22) << PHASE_NAMES[p] << right
+            << setw(12) << setprecision(3) << times.wall_seconds[p] * 1e3
+            << setw(12) << times.cpu_seconds[p] * 1e3
+            << setw(8) << setprecision(1) << 100.0 * times.wall_seconds[p] / run_wall << "%"
+            << setw(12) << times.entries[p] << "\n";
+    }
+    double other_wall = max(0.0, times.run_wall_seconds - times.phase_wall_seconds());
+    double other_cpu = max(0.0, times.run_cpu_seconds - times.phase_cpu_seconds());
+    out << left << setw(22) << "other" << right
+        << setw(12) << setprecision(3) << other_wall * 1e3
+        << setw(12) << other_cpu * 1e3
+        << setw(8) << setprecision(1) << 100.0 * other_wall / run_wall << "%" << "\n";
+    out << string(67, '-') << "\n";
+    out << left << setw(22) << "run" << right
+        << setw(12) << setprecision(3) << times.run_wall_seconds * 1e3
+        << setw(12) << times.run_cpu_seconds * 1e3 << "\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
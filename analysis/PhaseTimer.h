@@ -0,0 +1,103 @@
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include <iostream>
+
+using namespace std;
+
+// Phase Timer
+// Wall and thread-CPU time spent in each phase of a simulation run, to tell
+// whether a slow run is ranking, settling or writing its log. Timing is
+// compiled in with -DSIM_PHASE_TIMING; without it PHASE_SCOPE and
+// PHASE_RECORDER expand to nothing and the engine runs untimed.
+// Phases nest (a reservation is made inside the customer's decision), and
+// each phase is charged only the time not spent in phases nested in it,
+// so the phases add up to the timed part of the run.
+
+enum class SimPhase {
+    ARRIVAL_GENERATION,   // drawing customers and arrival times
+    RANKING,              // building the slate
+    CUSTOMER_DECISION,    // scoring the slate and choosing a store
+    RESERVATION,          // creating the reservation
+    SETTLEMENT,           // end-of-day reveal, pickups and cancellations
+    METRICS,              // logging events and aggregating the day
+    LOG_OUTPUT            // writing the detailed log and result files
+};
+
+const int NUM_SIM_PHASES = 7;
+
+const char* phase_name(SimPhase phase);
+
+struct PhaseTimes {
+    double wall_seconds[NUM_SIM_PHASES];
+    double cpu_seconds[NUM_SIM_PHASES];
+    long long entries[NUM_SIM_PHASES];
+
+    // Time spent inside PhaseRecorders on the recording thread, phases or not
+    double run_wall_seconds;
+    double run_cpu_seconds;
+
+    PhaseTimes();
+
+    // Add another thread's phases (e.g. a region shard's). Run totals are
+    // left alone, so merged phases may add up to more CPU than the run.
+    void add(const PhaseTimes& other);
+
+    double phase_wall_seconds() const;
+    double phase_cpu_seconds() const;
+};
+
+// Sends the phases timed on this thread to times while in scope, and adds
+// its own lifetime to the run totals (unless already recording into times)
+class PhaseRecorder {
+public:
+    explicit PhaseRecorder(PhaseTimes& times);
+    ~PhaseRecorder();
+
+private:
+    PhaseTimes* times;
+    PhaseTimes* previous_times;
+    class PhaseScope* previous_scope;
+    bool nested;
+    double wall_start, cpu_start;
+
+    PhaseRecorder(const PhaseRecorder&);
+    PhaseRecorder& operator=(const PhaseRecorder&);
+};
+
+// Times one phase on this thread (nothing when no recorder is active)
+class PhaseScope {
+public:
+    explicit PhaseScope(SimPhase phase);
+    ~PhaseScope();
+
+private:
+    friend class PhaseRecorder;
+    PhaseTimes* times;
+    PhaseScope* parent;
+    int phase;
+    double wall_start, cpu_start;
+    double nested_wall, nested_cpu;
+
+    PhaseScope(const PhaseScope&);
+    PhaseScope& operator=(const PhaseScope&);
+};
+
+#ifdef SIM_PHASE_TIMING
+#define PHASE_CONCAT_(a, b) a##b
+#define PHASE_CONCAT(a, b) PHASE_CONCAT_(a, b)
+#define PHASE_SCOPE(phase) PhaseScope PHASE_CONCAT(phase_scope_, __LINE__)(phase)
+#define PHASE_RECORDER(times) PhaseRecorder PHASE_CONCAT(phase_recorder_, __LINE__)(times)
+#else
+#define PHASE_SCOPE(phase) ((void)0)
+#define PHASE_RECORDER(times) ((void)0)
+#endif
+
+// True when built with SIM_PHASE_TIMING
+bool phase_timing_enabled();
+
+// Table of wall ms, CPU ms, share of the run and entries per phase, with
+// the untimed rest of the run (event dispatch, day setup) as "other"
+void write_phase_table(ostream& out, const PhaseTimes& times);
+
+#endif // PHASE_TIMER_H
@@ -0,0 +1,60 @@
+#include "RandomStream.h"
+
+using namespace std;
+
+// Philox4x32 constants (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+static const uint32_t PHILOX_M0 = 0xD2511F53u;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57u;
+static const uint32_t PHILOX_W0 = 0x9E3779B9u;
+static const uint32_t PHILOX_W1 = 0xBB67AE85u;
+static const int PHILOX_ROUNDS = 10;
+
+static void philox4x32(const uint32_t in[4], const uint32_t key_in[2], uint32_t out[4]) {
+    uint32_t c0 = in[0], c1 = in[1], c2 = in[2], c3 = in[3];
+    uint32_t k0 = key_in[0], k1 = key_in[1];
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c0 = n0;
+        c1 = (uint32_t)p1;
+        c2 = n2;
+        c3 = (uint32_t)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+RandomStream::RandomStream(uint64_t seed, StreamPurpose purpose, uint32_t day, uint32_t index)
+    : position(4) {
+    key[0] = (uint32_t)seed;
+    key[1] = (uint32_t)(seed >> 32);
+    counter[0] = 0;
+    counter[1] = index;
+    counter[2] = day;
+    counter[3] = (uint32_t)purpose;
+}
+
+RandomStream::result_type RandomStream::operator()() {
+    if (position == 4) {
+        philox4x32(counter, key, block);
+        counter[0]++;
+        position = 0;
+    }
+    return block[position++];
+}
+
+float RandomStream::uniform() {
+    return ((*this)() >> 8) * (1.0f / 16777216.0f);
+}
+
+double RandomStream::open_uniform() {
+    uint64_t high = (*this)() >> 6;    // 26 bits
+    uint64_t low = (*this)() >> 5;     // 27 bits
+    return ((double)((high << 27) | low) + 0.5) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,55 @@
+#ifndef RANDOM_STREAM_H
+#define RANDOM_STREAM_H
+
+#include <cstdint>
+
+using namespace std;
+
+// Seed used when none is given (the value the shared generator always used)
+const uint64_t DEFAULT_SIMULATION_SEED = 12345;
+
+// What a stream is used for; part of the stream's address
+enum class StreamPurpose : uint32_t {
+    ARRIVAL_TIMES,      // index unused, one stream per day
+    CUSTOMER_PROFILE,   // index = customer id
+    CSV_FILL,           // index = CSV row, for columns missing from the file
+    INVENTORY,          // index = store slot; day 0 is the initial stock
+    STORE_CHOICE,       // index = customer id
+    SCENARIO_AREA,      // index = neighbourhood of a synthetic city
+    SCENARIO_STORE,     // index = synthetic store
+    SCENARIO_CUSTOMER   // index = synthetic customer
+};
+
+// Random Stream
+// Counter-based generator (Philox4x32-10). Output block k of the stream
+// addressed by (seed, purpose, day, index) is a pure function of those
+// values, so any stream can be created anywhere, in any order or on any
+// thread, and always yields the same numbers for the same seed.
+// Satisfies UniformRandomBitGenerator, so it plugs into <random>.
+class RandomStream {
+public:
+    typedef uint32_t result_type;
+
+    RandomStream(uint64_t seed = DEFAULT_SIMULATION_SEED,
+                 StreamPurpose purpose = StreamPurpose::CUSTOMER_PROFILE,
+                 uint32_t day = 0, uint32_t index = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    result_type operator()();
+
+    // Uniform float in [0, 1) with 24 random bits
+    float uniform();
+
+    // Uniform double in (0, 1) with 53 random bits; never 0, so safe for log
+    double open_uniform();
+
+private:
+    uint32_t key[2];
+    uint32_t counter[4];   // block number, index, day, purpose
+    uint32_t block[4];
+    int position;          // next unread word of block (4 = exhausted)
+};
+
+#endif // RANDOM_STREAM_H
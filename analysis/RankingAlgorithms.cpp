@@ -1,156 +1,188 @@
 #include "RankingAlgorithms.h"
 #include <algorithm>
-#include <set>
 #include <cmath>
-#include <limits>
 #include "Customer.h"
+#include "TopKSelector.h"
+#include "StoreScoring.h"
+#include "ArrivalContext.h"
+#include "RankingWorkspace.h"
 
 using namespace std;
 
-// Distance threshold defined in Customer.cpp
-extern const float MAX_TRAVEL_DISTANCE;
+// Available slots within travel distance of the customer, in catalog
+// order, left in the workspace's reachable list
+static void find_reachable_slots(const Customer& customer, const MarketState& market_state,
+                                 const ArrivalContext& context, RankingWorkspace& ws) {
+    if (context.preset_count >= 0) {
+        ws.reachable.assign(context.preset_candidates, context.preset_candidates + context.preset_count);
+        return;
+    }
 
-// Baseline Algorithm: Just sorts by rating
-vector<int> get_displayed_stores_baseline(const Customer& customer,
-                                                const MarketState& market_state,
-                                                int n_displayed) {
-    vector<int> available = market_state.get_available_restaurant_ids();
+    const SlotBitset& available = market_state.get_available_slots();
+    ws.reachable.clear();
+    market_state.get_spatial_index().query_radius(customer.latitude, customer.longitude,
+                                                  market_state.get_travel_distance(), ws.reachable);
+    size_t kept = 0;
+    for (int slot : ws.reachable) {
+        if (available.test(slot)) {
+            ws.reachable[kept++] = slot;
+        }
+    }
+    ws.reachable.resize(kept);
+    sort(ws.reachable.begin(), ws.reachable.end());
+}
 
-    sort(available.begin(), available.end(),
-        [&market_state](int a, int b) {
-            const Restaurant* r1 = nullptr;
-            const Restaurant* r2 = nullptr;
+// Fill the context's candidates with the reachable available stores and
+// their base scores. Stores outside the travel radius all score -100.
+static void collect_candidates(const Customer& customer, const MarketState& market_state,
+                               RankingWorkspace& ws, ArrivalContext& context) {
+    const StoreTable& stores = market_state.get_store_table();
+    find_reachable_slots(customer, market_state, context, ws);
+    context.candidates.assign(ws.reachable.begin(), ws.reachable.end());
 
-            for (const auto& r : market_state.restaurants) {
-                if (r.business_id == a) r1 = &r;
-                if (r.business_id == b) r2 = &r;
-            }
+    // Scores computed ahead of time (batch ranking) are only copied
+    if (context.preset_count >= 0 && context.preset_scores) {
+        context.candidate_scores.assign(context.preset_scores, context.preset_scores + context.preset_count);
+        return;
+    }
+    context.candidate_scores.resize(context.candidates.size());
 
-            if (!r1 || !r2) return false;
-            return r1->get_rating() > r2->get_rating();
-        });
+    ws.scoring.load(customer, stores);
+    score_store_slots(ws.scoring, stores, context.candidates.data(), (int)context.candidates.size(),
+                      context.candidate_scores.data());
+}
 
-    int num_to_show = min(n_displayed, (int)available.size());
-    return vector<int>(available.begin(), available.begin() + num_to_show);
+// Baseline Algorithm: Top-rated stores
+// Walks the rating index maintained by MarketState and keeps the first N
+// stores that can still take a reservation.
+const vector<int>& get_displayed_stores_baseline(const Customer& customer,
+                                                const MarketState& market_state,
+                                                int n_displayed,
+                                                ArrivalContext& context) {
+    const StoreTable& stores = market_state.get_store_table();
+    context.reset();
+    RankingWorkspace& ws = ranking_workspace();
+    ws.begin_arrival(stores.size(), n_displayed);
+    const SlotBitset& available = market_state.get_available_slots();
+    SlateBuffer& result = ws.slate;
+    for (int slot : market_state.get_rating_order()) {
+        if ((int)result.size() >= n_displayed) break;
+        if (available.test(slot)) {
+            result.push_back(slot);
+        }
+    }
+    context.set_slate(result.data(), result.size(), customer, stores);
+    return context.slate_ids;
 }
 
 // Sama's Algorithm: Complex multi-objective optimization
 // Balances personalization, waste reduction, fairness, and revenue
-vector<int> get_displayed_stores_sama(const Customer& customer,
+const vector<int>& get_displayed_stores_sama(const Customer& customer,
                                             const MarketState& market_state,
-                                            int n_displayed) {
-    vector<int> available = market_state.get_available_restaurant_ids();
-    if (available.empty()) return available;
+                                            int n_displayed,
+                                            ArrivalContext& context) {
+    const StoreTable& stores = market_state.get_store_table();
+    context.reset();
+    RankingWorkspace& ws = ranking_workspace();
+    ws.begin_arrival(stores.size(), n_displayed);
+    const SlotBitset& available = market_state.get_available_slots();
+    if (available.empty()) return context.slate_ids;
+
+    // Customer preference score for the stores in reach
+    collect_candidates(customer, market_state, ws, context);
+    size_t next_candidate = 0;
 
-    vector<int> result;
-    set<int> selected;
+    SlateBuffer& result = ws.slate;
+    SlotBitset& selected = ws.selected;
 
     // Determine segment characteristics
-    bool is_budget = (customer.segment == "budget");
-    bool is_premium = (customer.segment == "premium");
-    bool is_regular = (customer.segment == "regular");
+    bool is_budget = (customer.segment == CustomerSegment::BUDGET);
+    bool is_premium = (customer.segment == CustomerSegment::PREMIUM);
+    const SegmentRankingParams& segment_params = SEGMENT_RANKING[(int)customer.segment];
     
     // Segment weights
-    float segment_rating_weight = is_premium ? 1.5f : (is_budget ? 0.8f : 1.0f);
-    float segment_price_weight = is_budget ? 1.3f : (is_premium ? 0.7f : 1.0f);
-    float segment_inventory_weight = is_budget ? 0.8f : (is_premium ? 0.5f : 0.6f);
-    
-    // Calculate comprehensive scores
-    vector<pair<int, float>> store_scores;
-    for (int store_id : available) {
-        const Restaurant* store = nullptr;
-        for (const auto& r : market_state.restaurants) {
-            if (r.business_id == store_id) {
-                store = &r;
-                break;
-            }
+    float segment_rating_weight = segment_params.rating_weight;
+    float segment_inventory_weight = segment_params.inventory_weight;
+    
+    // Calculate comprehensive scores (keyed by slot)
+    // Only the best 2N can reach the slate: SELECT 1 and SELECT 4 walk this
+    // list and skip at most N-1 stores picked by the other steps.
+    TopKSelector& top_stores = ws.ranking;
+    top_stores.reset(2 * n_displayed);
+    int scored_count = 0;
+    for (int slot : available) {
+        // Base customer preference score (-100 when out of reach)
+        float base_score = -100.0f;
+        if (next_candidate < context.candidates.size() && context.candidates[next_candidate] == slot) {
+            base_score = context.candidate_scores[next_candidate++];
         }
-        if (store) {
-            // Base customer preference score
-            float base_score = customer.calculate_store_score(*store);
-            
-            // Inventory urgency (reduce waste)
-            int unsold_bags = max(0, store->estimated_bags - store->reserved_count);
-            float inventory_urgency = min(1.0f, (float)unsold_bags / 15.0f);
-            float inventory_bonus = inventory_urgency * 1.2f * segment_inventory_weight;
-            
-            // Distance (partially covered in base_score)
-            float distance_bonus = 0.0f;
-            
-            // Rating bonus
-            float rating_bonus = (store->get_rating() - 3.5f) * 0.3f * segment_rating_weight;
-            if (rating_bonus < 0) rating_bonus = 0;
-            
-            // Price bonus based on segment
-            float price_bonus = 0.0f;
-            if (is_budget) {
-                if (store->price_per_bag < customer.willingness_to_pay) {
-                    float price_savings = (customer.willingness_to_pay - store->price_per_bag) / customer.willingness_to_pay;
-                    price_bonus = price_savings * 0.4f;
-                }
-            } else if (is_premium) {
-                if (store->price_per_bag > 100.0f) {
-                    price_bonus = 0.1f;
-                }
-            }
-            
-            // Interaction history bonus
-            float history_bonus = 0.0f;
-            auto hist_it = customer.history.store_interactions.find(store_id);
-            if (hist_it != customer.history.store_interactions.end() && 
-                hist_it->second.reservations > 0) {
-                float success_rate = (float)hist_it->second.successes / hist_it->second.reservations;
-                history_bonus = success_rate * 0.5f;
-                
-                if (hist_it->second.cancellations > 0) {
-                    float cancel_rate = (float)hist_it->second.cancellations / hist_it->second.reservations;
-                    history_bonus -= cancel_rate * 1.0f;
-                }
+        
+        // Inventory urgency (reduce waste)
+        int unsold_bags = stores.unsold_bags(slot);
+        float inventory_urgency = min(1.0f, (float)unsold_bags / 15.0f);
+        float inventory_bonus = inventory_urgency * 1.2f * segment_inventory_weight;
+        
+        // Distance (partially covered in base_score)
+        float distance_bonus = 0.0f;
+        
+        // Rating bonus
+        float rating_bonus = (stores.rating[slot] - 3.5f) * 0.3f * segment_rating_weight;
+        if (rating_bonus < 0) rating_bonus = 0;
+        
+        // Price bonus based on segment
+        float price_bonus = 0.0f;
+        if (is_budget) {
+            if (stores.price_per_bag[slot] < customer.willingness_to_pay) {
+                float price_savings = (customer.willingness_to_pay - stores.price_per_bag[slot]) / customer.willingness_to_pay;
+                price_bonus = price_savings * 0.4f;
             }
-            
-            // Category preference bonus
-            float category_bonus = 0.0f;
-            auto cat_it = customer.category_preference.find(store->business_type);
-            if (cat_it != customer.category_preference.end()) {
-                category_bonus = cat_it->second * 0.2f;
+        } else if (is_premium) {
+            if (stores.price_per_bag[slot] > 100.0f) {
+                price_bonus = 0.1f;
             }
+        }
+        
+        // Interaction history bonus
+        float history_bonus = 0.0f;
+        const StoreInteraction* interaction = customer.history.store_interactions.find(slot);
+        if (interaction && interaction->reservations > 0) {
+            float success_rate = (float)interaction->successes / interaction->reservations;
+            history_bonus = success_rate * 0.5f;
             
-            // High waste reduction priority
-            float waste_reduction_bonus = 0.0f;
-            if (unsold_bags > 5) {
-                waste_reduction_bonus = min(2.0f, (float)unsold_bags / 5.0f) * 0.5f;
+            if (interaction->cancellations > 0) {
+                float cancel_rate = (float)interaction->cancellations / interaction->reservations;
+                history_bonus -= cancel_rate * 1.0f;
             }
-            
-            // Revenue optimization
-            float revenue_potential = store->price_per_bag * inventory_urgency;
-            float revenue_bonus = (revenue_potential / 200.0f) * 0.3f;
-            
-            float final_score = base_score + inventory_bonus + rating_bonus + price_bonus + 
-                              history_bonus + category_bonus + distance_bonus + 
-                              waste_reduction_bonus + revenue_bonus;
-            store_scores.push_back({store_id, final_score});
         }
+        
+        // Category preference bonus
+        float category_bonus = customer.get_category_preference(stores.category[slot]) * 0.2f;
+        
+        // High waste reduction priority
+        float waste_reduction_bonus = 0.0f;
+        if (unsold_bags > 5) {
+            waste_reduction_bonus = min(2.0f, (float)unsold_bags / 5.0f) * 0.5f;
+        }
+        
+        // Revenue optimization
+        float revenue_potential = stores.price_per_bag[slot] * inventory_urgency;
+        float revenue_bonus = (revenue_potential / 200.0f) * 0.3f;
+        
+        float final_score = base_score + inventory_bonus + rating_bonus + price_bonus + 
+                          history_bonus + category_bonus + distance_bonus + 
+                          waste_reduction_bonus + revenue_bonus;
+        top_stores.offer(slot, final_score);
+        scored_count++;
     }
-
-    sort(store_scores.begin(), store_scores.end(),
-        [](const pair<int, float>& a, const pair<int, float>& b) {
-            return a.second > b.second;
-        });
+    const vector<pair<int, float>>& store_scores = top_stores.sorted();
 
     // Adaptive personalization logic
-    float base_personalization = is_budget ? 0.7f : (is_premium ? 0.5f : 0.6f);
+    float base_personalization = segment_params.base_personalization;
     float loyalty_adjustment = customer.loyalty * 0.15f;
     
     // Check overall market waste status
-    float total_unsold = 0.0f;
-    int stores_with_inventory = 0;
-    for (const auto& r : market_state.restaurants) {
-        int unsold = max(0, r.estimated_bags - r.reserved_count);
-        if (unsold > 0) {
-            total_unsold += unsold;
-            stores_with_inventory++;
-        }
-    }
+    float total_unsold = (float)market_state.get_total_unsold_bags();
+    int stores_with_inventory = market_state.get_stores_with_unsold_bags();
     float avg_unsold = stores_with_inventory > 0 ? total_unsold / stores_with_inventory : 0.0f;
     
     // Adjust personalization if waste is high
@@ -159,154 +191,129 @@ vector<int> get_displayed_stores_sama(const Customer& customer,
     float personalization_ratio = base_personalization + loyalty_adjustment + waste_adjustment;
     personalization_ratio = min(0.85f, max(0.4f, personalization_ratio));
     
-    int personalized_count = min((int)(n_displayed * personalization_ratio), (int)store_scores.size());
+    int personalized_count = min((int)(n_displayed * personalization_ratio), scored_count);
     personalized_count = max(3, personalized_count);
     
     // SELECT 1: Personalized stores
-    for (int i = 0; i < personalized_count && result.size() < n_displayed; i++) {
-        int store_id = store_scores[i].first;
-        result.push_back(store_id);
-        selected.insert(store_id);
+    for (int i = 0; i < personalized_count && i < (int)store_scores.size() && result.size() < n_displayed; i++) {
+        int slot = store_scores[i].first;
+        result.push_back(slot);
+        selected.assign(slot, true);
     }
 
     // SELECT 2: Discovery stores (segment-aware)
     if (result.size() < n_displayed) {
-        vector<pair<int, float>> quality_new_stores;
-        for (int store_id : available) {
-            if (selected.find(store_id) != selected.end()) continue;
-            
+        TopKSelector& quality_new_stores = ws.pick_a;
+        quality_new_stores.reset(1);
+        for (int slot : available) {
+            if (selected.test(slot)) continue;
             // Is it a new store for this customer?
-            auto hist_it = customer.history.store_interactions.find(store_id);
-            bool is_new = (hist_it == customer.history.store_interactions.end() || 
-                          hist_it->second.reservations == 0);
+            const StoreInteraction* interaction = customer.history.store_interactions.find(slot);
+            bool is_new = (!interaction || interaction->reservations == 0);
             
             if (is_new) {
-                const Restaurant* store = nullptr;
-                for (const auto& r : market_state.restaurants) {
-                    if (r.business_id == store_id) {
-                        store = &r;
-                        break;
+                bool meets_threshold = false;
+                float quality_score = 0.0f;
+                
+                int unsold = stores.unsold_bags(slot);
+                float unsold_bonus = min(1.0f, (float)unsold / 10.0f);
+                
+                if (is_budget) {
+                    if (stores.price_per_bag[slot] <= customer.willingness_to_pay * 1.1f && 
+                        stores.estimated_bags[slot] >= 8 && stores.rating[slot] >= 3.8f) {
+                        float value_ratio = stores.rating[slot] / stores.price_per_bag[slot];
+                        float price_affordability = (customer.willingness_to_pay - stores.price_per_bag[slot]) / customer.willingness_to_pay;
+                        float inventory_safety = min(1.0f, (float)stores.estimated_bags[slot] / 15.0f);
+                        quality_score = value_ratio * 15.0f + price_affordability * 2.0f + 
+                                      inventory_safety * 0.5f + stores.rating[slot] * 0.3f + unsold_bonus * 0.8f;
+                        meets_threshold = true;
                     }
-                }
-                if (store) {
-                    bool meets_threshold = false;
-                    float quality_score = 0.0f;
-                    
-                    int unsold = max(0, store->estimated_bags - store->reserved_count);
-                    float unsold_bonus = min(1.0f, (float)unsold / 10.0f);
-                    
-                    if (is_budget) {
-                        if (store->price_per_bag <= customer.willingness_to_pay * 1.1f && 
-                            store->estimated_bags >= 8 && store->get_rating() >= 3.8f) {
-                            float value_ratio = store->get_rating() / store->price_per_bag;
-                            float price_affordability = (customer.willingness_to_pay - store->price_per_bag) / customer.willingness_to_pay;
-                            float inventory_safety = min(1.0f, (float)store->estimated_bags / 15.0f);
-                            quality_score = value_ratio * 15.0f + price_affordability * 2.0f + 
-                                          inventory_safety * 0.5f + store->get_rating() * 0.3f + unsold_bonus * 0.8f;
-                            meets_threshold = true;
-                        }
-                    } else if (is_premium) {
-                        if (store->get_rating() >= 4.0f && store->estimated_bags >= 8) {
-                            float value_score = store->get_rating() / store->price_per_bag;
-                            float inventory_bonus = min(1.0f, (float)store->estimated_bags / 15.0f);
-                            quality_score = store->get_rating() * 1.5f + value_score * 10.0f + 
-                                          inventory_bonus * 0.5f + unsold_bonus * 0.6f;
-                            meets_threshold = true;
-                        }
-                    } else {
-                        if (store->get_rating() >= 3.9f && store->estimated_bags >= 8) {
-                            float value_score = store->get_rating() / store->price_per_bag;
-                            float inventory_bonus = min(1.0f, (float)store->estimated_bags / 15.0f);
-                            quality_score = store->get_rating() + value_score * 10.0f + 
-                                          inventory_bonus * 0.5f + unsold_bonus * 0.7f;
-                            meets_threshold = true;
-                        }
+                } else if (is_premium) {
+                    if (stores.rating[slot] >= 4.0f && stores.estimated_bags[slot] >= 8) {
+                        float value_score = stores.rating[slot] / stores.price_per_bag[slot];
+                        float inventory_bonus = min(1.0f, (float)stores.estimated_bags[slot] / 15.0f);
+                        quality_score = stores.rating[slot] * 1.5f + value_score * 10.0f + 
+                                      inventory_bonus * 0.5f + unsold_bonus * 0.6f;
+                        meets_threshold = true;
                     }
-                    
-                    if (meets_threshold) {
-                        quality_new_stores.push_back({store_id, quality_score});
+                } else {
+                    if (stores.rating[slot] >= 3.9f && stores.estimated_bags[slot] >= 8) {
+                        float value_score = stores.rating[slot] / stores.price_per_bag[slot];
+                        float inventory_bonus = min(1.0f, (float)stores.estimated_bags[slot] / 15.0f);
+                        quality_score = stores.rating[slot] + value_score * 10.0f + 
+                                      inventory_bonus * 0.5f + unsold_bonus * 0.7f;
+                        meets_threshold = true;
                     }
                 }
+                
+                if (meets_threshold) {
+                    quality_new_stores.offer(slot, quality_score);
+                }
             }
         }
         
-        if (!quality_new_stores.empty()) {
-            sort(quality_new_stores.begin(), quality_new_stores.end(),
-                [](const pair<int, float>& a, const pair<int, float>& b) {
-                    return a.second > b.second;
-                });
-            
-            result.push_back(quality_new_stores[0].first);
-            selected.insert(quality_new_stores[0].first);
+        if (quality_new_stores.size() > 0) {
+            int best_slot = quality_new_stores.sorted()[0].first;
+            result.push_back(best_slot);
+            selected.assign(best_slot, true);
         }
     }
 
     // SELECT 3: Price-competitive selection
     if (result.size() < n_displayed) {
-        vector<pair<int, float>> competitive_stores;
-        for (int store_id : available) {
-            if (selected.find(store_id) != selected.end()) continue;
+        TopKSelector& competitive_stores = ws.pick_b;
+        competitive_stores.reset(1);
+        for (int slot : available) {
+            if (selected.test(slot)) continue;
             
-            const Restaurant* store = nullptr;
-            for (const auto& r : market_state.restaurants) {
-                if (r.business_id == store_id) {
-                    store = &r;
-                    break;
-                }
-            }
-            if (store) {
-                if (store->estimated_bags >= 8) {
-                    float value_ratio = store->get_rating() / store->price_per_bag;
-                    float inventory_safety = min(1.0f, (float)store->estimated_bags / 15.0f);
-                    float competitive_score = 0.0f;
-                    bool is_competitive = false;
-                    
-                    if (is_budget) {
-                        if (store->price_per_bag <= customer.willingness_to_pay * 1.1f && value_ratio > 0.025f) {
-                            float price_affordability = (customer.willingness_to_pay - store->price_per_bag) / customer.willingness_to_pay;
-                            competitive_score = value_ratio * 120.0f + price_affordability * 3.0f + inventory_safety * 0.5f + store->get_rating() * 0.3f;
-                            is_competitive = true;
-                        }
-                    } else if (is_premium) {
-                        if (value_ratio > 0.03f && store->get_rating() >= 3.8f) {
-                            competitive_score = value_ratio * 100.0f + inventory_safety * 0.5f + store->get_rating() * 0.8f;
-                            is_competitive = true;
-                        }
-                    } else {
-                        if (value_ratio > 0.03f) {
-                            competitive_score = value_ratio * 100.0f + inventory_safety * 0.5f + store->get_rating() * 0.5f;
-                            is_competitive = true;
-                        }
+            if (stores.estimated_bags[slot] >= 8) {
+                float value_ratio = stores.rating[slot] / stores.price_per_bag[slot];
+                float inventory_safety = min(1.0f, (float)stores.estimated_bags[slot] / 15.0f);
+                float competitive_score = 0.0f;
+                bool is_competitive = false;
+                
+                if (is_budget) {
+                    if (stores.price_per_bag[slot] <= customer.willingness_to_pay * 1.1f && value_ratio > 0.025f) {
+                        float price_affordability = (customer.willingness_to_pay - stores.price_per_bag[slot]) / customer.willingness_to_pay;
+                        competitive_score = value_ratio * 120.0f + price_affordability * 3.0f + inventory_safety * 0.5f + stores.rating[slot] * 0.3f;
+                        is_competitive = true;
+                    }
+                } else if (is_premium) {
+                    if (value_ratio > 0.03f && stores.rating[slot] >= 3.8f) {
+                        competitive_score = value_ratio * 100.0f + inventory_safety * 0.5f + stores.rating[slot] * 0.8f;
+                        is_competitive = true;
                     }
-                    
-                    if (is_competitive) {
-                        competitive_stores.push_back({store_id, competitive_score});
+                } else {
+                    if (value_ratio > 0.03f) {
+                        competitive_score = value_ratio * 100.0f + inventory_safety * 0.5f + stores.rating[slot] * 0.5f;
+                        is_competitive = true;
                     }
                 }
+                
+                if (is_competitive) {
+                    competitive_stores.offer(slot, competitive_score);
+                }
             }
         }
         
-        if (!competitive_stores.empty()) {
-            sort(competitive_stores.begin(), competitive_stores.end(),
-                [](const pair<int, float>& a, const pair<int, float>& b) {
-                    return a.second > b.second;
-                });
-            
-            result.push_back(competitive_stores[0].first);
-            selected.insert(competitive_stores[0].first);
+        if (competitive_stores.size() > 0) {
+            int best_slot = competitive_stores.sorted()[0].first;
+            result.push_back(best_slot);
+            selected.assign(best_slot, true);
         }
     }
 
     // SELECT 4: Fill remaining with best available
     for (size_t i = 0; i < store_scores.size() && result.size() < n_displayed; i++) {
-        int store_id = store_scores[i].first;
-        if (selected.find(store_id) == selected.end()) {
-            result.push_back(store_id);
-            selected.insert(store_id);
+        int slot = store_scores[i].first;
+        if (!selected.test(slot)) {
+            result.push_back(slot);
+            selected.assign(slot, true);
         }
     }
 
-    return result;
+    context.set_slate(result.data(), result.size(), customer, stores);
+    return context.slate_ids;
 }
 
 // Distance helper
@@ -317,216 +324,208 @@ static float calculate_distance(float lat1, float lon1, float lat2, float lon2)
 }
 
 // Andrew's Algorithm: Prioritizes Fairness using impression counts
-vector<int> get_displayed_stores_andrew(const Customer& customer,
-                                             MarketState& market_state,
-                                             int n_displayed) {
-    vector<int> available = market_state.get_available_restaurant_ids();
-    if (available.empty()) return available;
+const vector<int>& get_displayed_stores_andrew(const Customer& customer,
+                                             const MarketState& market_state,
+                                             int n_displayed,
+                                             ArrivalContext& context) {
+    const StoreTable& stores = market_state.get_store_table();
+    context.reset();
+    RankingWorkspace& ws = ranking_workspace();
+    ws.begin_arrival(stores.size(), n_displayed);
+    const SlotBitset& available = market_state.get_available_slots();
+    if (available.empty()) return context.slate_ids;
+
+    // Customer preference score for the stores in reach
+    collect_candidates(customer, market_state, ws, context);
+    size_t next_candidate = 0;
 
-    vector<pair<int, float>> store_scores;
+    TopKSelector& store_scores = ws.ranking;
+    store_scores.reset(n_displayed);
     
-    for (int store_id : available) {
-        const Restaurant* store = market_state.get_restaurant(store_id);
-        if (!store) continue;
-        
-        float base_score = customer.calculate_store_score(*store);
+    for (int slot : available) {
+        float base_score = -100.0f;
+        if (next_candidate < context.candidates.size() && context.candidates[next_candidate] == slot) {
+            base_score = context.candidate_scores[next_candidate++];
+        }
         
         // Dampen score if store has been shown many times
-        int impressions = market_state.impression_counts[store_id];
+        int impressions = market_state.get_impressions(slot);
         float damping_factor = log(impressions + 1.0f) + 1.0f;
         float adjusted_score = base_score / damping_factor;
         
-        store_scores.push_back({store_id, adjusted_score});
+        store_scores.offer(slot, adjusted_score);
     }
     
-    sort(store_scores.begin(), store_scores.end(),
-        [](const pair<int, float>& a, const pair<int, float>& b) {
-            return a.second > b.second;
-        });
-    
-    int num_to_show = min(n_displayed, (int)store_scores.size());
-    vector<int> result;
-    for (int i = 0; i < num_to_show; i++) {
-        result.push_back(store_scores[i].first);
+    SlateBuffer& result = ws.slate;
+    for (const auto& entry : store_scores.sorted()) {
+        result.push_back(entry.first);
     }
     
-    return result;
+    context.set_slate(result.data(), result.size(), customer, stores);
+    return context.slate_ids;
 }
 
 // Amer's Algorithm: Prioritizes closest store first
-vector<int> get_displayed_stores_amer(const Customer& customer,
+const vector<int>& get_displayed_stores_amer(const Customer& customer,
                                            const MarketState& market_state,
-                                           int n_displayed) {
-    vector<int> available = market_state.get_available_restaurant_ids();
-    if (available.empty()) return available;
+                                           int n_displayed,
+                                           ArrivalContext& context) {
+    const StoreTable& stores = market_state.get_store_table();
+    context.reset();
+    RankingWorkspace& ws = ranking_workspace();
+    ws.begin_arrival(stores.size(), n_displayed);
 
-    vector<int> result;
-    set<int> selected;
+    SlateBuffer& result = ws.slate;
+    SlotBitset& selected = ws.selected;
     
     // Step 1: Find absolute closest store
-    int closest_store_id = -1;
-    float min_distance = numeric_limits<float>::max();
-    
-    for (int store_id : available) {
-        const Restaurant* store = market_state.get_restaurant(store_id);
-        if (!store) continue;
-        
-        float distance = calculate_distance(customer.latitude, customer.longitude,
-                                           store->latitude, store->longitude);
-        
-        if (distance < min_distance && distance <= MAX_TRAVEL_DISTANCE) {
-            min_distance = distance;
-            closest_store_id = store_id;
-        }
+    const SlotBitset& available_slots = market_state.get_available_slots();
+    int closest_slot = market_state.get_spatial_index().nearest(
+        customer.latitude, customer.longitude, market_state.get_travel_distance(),
+        [&available_slots](int slot) { return available_slots.test(slot); });
+    
+    if (closest_slot != -1) {
+        result.push_back(closest_slot);
+        selected.assign(closest_slot, true);
     }
     
-    if (closest_store_id != -1) {
-        result.push_back(closest_store_id);
-        selected.insert(closest_store_id);
-    }
+    // Customer preference score for the reachable stores only
+    collect_candidates(customer, market_state, ws, context);
+    const vector<int>& available = context.candidates;
+    const vector<float>& base_scores = context.candidate_scores;
     
     // Step 2: Score remaining, penalizing price and distance heavily
-    vector<pair<int, float>> store_scores;
+    TopKSelector& store_scores = ws.ranking;
+    store_scores.reset(n_displayed - result.size());
     
-    for (int store_id : available) {
-        if (selected.find(store_id) != selected.end()) continue;
-        
-        const Restaurant* store = market_state.get_restaurant(store_id);
-        if (!store) continue;
+    for (size_t i = 0; i < available.size(); i++) {
+        int slot = available[i];
+        if (selected.test(slot)) continue;
         
         float distance = calculate_distance(customer.latitude, customer.longitude,
-                                           store->latitude, store->longitude);
-        if (distance > MAX_TRAVEL_DISTANCE) continue;
+                                           stores.latitude[slot], stores.longitude[slot]);
         
-        float base_score = customer.calculate_store_score(*store);
-        float price_penalty = store->price_per_bag * 0.01f;
+        float base_score = base_scores[i];
+        float price_penalty = stores.price_per_bag[slot] * 0.01f;
         float distance_penalty = distance * 20.0f;
         
         float final_score = base_score - price_penalty - distance_penalty;
         
-        store_scores.push_back({store_id, final_score});
+        store_scores.offer(slot, final_score);
     }
     
-    sort(store_scores.begin(), store_scores.end(),
-        [](const pair<int, float>& a, const pair<int, float>& b) {
-            return a.second > b.second;
-        });
-    
-    int remaining = n_displayed - (int)result.size();
-    for (int i = 0; i < remaining && i < (int)store_scores.size(); i++) {
-        result.push_back(store_scores[i].first);
-        selected.insert(store_scores[i].first);
+    for (const auto& entry : store_scores.sorted()) {
+        result.push_back(entry.first);
+        selected.assign(entry.first, true);
     }
     
-    return result;
+    context.set_slate(result.data(), result.size(), customer, stores);
+    return context.slate_ids;
 }
 
 // Ziad's Algorithm: Weighted linear combination (Price, Rating, Unsold)
-vector<int> get_displayed_stores_ziad(const Customer& customer,
+const vector<int>& get_displayed_stores_ziad(const Customer& customer,
                                             const MarketState& market_state,
-                                            int n_displayed) {
-    vector<int> available = market_state.get_available_restaurant_ids();
-    if (available.empty()) return available;
-
+                                            int n_displayed,
+                                            ArrivalContext& context) {
+    const StoreTable& stores = market_state.get_store_table();
+    context.reset();
+    RankingWorkspace& ws = ranking_workspace();
+    ws.begin_arrival(stores.size(), n_displayed);
     const float price_weight = -0.01f;
     const float rating_weight = 1.5f;
     const float unsold_weight = 0.1f;
 
-    vector<pair<int, float>> store_scores;
-    
-    for (int store_id : available) {
-        const Restaurant* store = market_state.get_restaurant(store_id);
-        if (!store) continue;
-        
-        float distance = calculate_distance(customer.latitude, customer.longitude,
-                                           store->latitude, store->longitude);
-        if (distance > MAX_TRAVEL_DISTANCE) continue;
-        
-        int unsold_bags = max(0, store->estimated_bags - store->reserved_count);
+    int num_to_show = min(n_displayed, 5);
+    TopKSelector& store_scores = ws.ranking;
+    store_scores.reset(num_to_show);
+    if (num_to_show <= 0) return context.slate_ids;
+
+    // Only stores within travel distance are eligible
+    find_reachable_slots(customer, market_state, context, ws);
+    for (int slot : ws.reachable) {
+        int unsold_bags = stores.unsold_bags(slot);
         
-        float score = (price_weight * store->price_per_bag) + 
-                      (rating_weight * store->get_rating()) + 
+        float score = (price_weight * stores.price_per_bag[slot]) + 
+                      (rating_weight * stores.rating[slot]) + 
                       (unsold_weight * unsold_bags);
         
-        store_scores.push_back({store_id, score});
+        store_scores.offer(slot, score);
     }
     
-    sort(store_scores.begin(), store_scores.end(),
-        [](const pair<int, float>& a, const pair<int, float>& b) {
-            return a.second > b.second;
-        });
-    
-    int num_to_show = min(n_displayed, min(5, (int)store_scores.size()));
-    vector<int> result;
-    for (int i = 0; i < num_to_show; i++) {
-        result.push_back(store_scores[i].first);
+    SlateBuffer& result = ws.slate;
+    for (const auto& entry : store_scores.sorted()) {
+        result.push_back(entry.first);
     }
     
-    return result;
+    context.set_slate(result.data(), result.size(), customer, stores);
+    return context.slate_ids;
 }
 
 // Harmony Algorithm: The final/best strategy combining all strengths
-vector<int> get_displayed_stores_harmony(const Customer& customer,
-                                         MarketState& market_state,
-                                         int n_displayed) {
-    vector<int> available = market_state.get_available_restaurant_ids();
-    if (available.empty()) return available;
+const vector<int>& get_displayed_stores_harmony(const Customer& customer,
+                                         const MarketState& market_state,
+                                         int n_displayed,
+                                         ArrivalContext& context) {
+    const StoreTable& stores = market_state.get_store_table();
+    context.reset();
+    RankingWorkspace& ws = ranking_workspace();
+    ws.begin_arrival(stores.size(), n_displayed);
+
+    // Only stores within travel distance are scored
+    collect_candidates(customer, market_state, ws, context);
+    const vector<int>& available = context.candidates;
+    const vector<float>& base_scores = context.candidate_scores;
 
-    vector<int> result;
-    set<int> selected;
+    SlateBuffer& result = ws.slate;
+    SlotBitset& selected = ws.selected;
 
     // STEP 1: Calculate scores for all stores
-    vector<pair<int, float>> store_scores;
+    // Besides the overall ranking, keep the best candidates for the
+    // high-waste and discovery picks so later steps never rescan the list.
+    int direct_slots = (int)(n_displayed * 0.7f);
+    TopKSelector& store_scores = ws.ranking;
+    TopKSelector& high_waste_stores = ws.pick_a;
+    TopKSelector& discovery_stores = ws.pick_b;
+    store_scores.reset(2 * n_displayed);
+    high_waste_stores.reset(direct_slots + 1);
+    discovery_stores.reset(direct_slots + 2);
     
     // Average impressions for fairness calculation
-    float total_impressions = 0.0f;
-    int store_count = 0;
-    for (const auto& pair : market_state.impression_counts) {
-        total_impressions += pair.second;
-        store_count++;
-    }
-    float avg_impressions = store_count > 0 ? total_impressions / store_count : 1.0f;
+    float avg_impressions = market_state.get_average_impressions();
+    const SegmentRankingParams& segment_params = SEGMENT_RANKING[(int)customer.segment];
     
-    for (int store_id : available) {
-        const Restaurant* store = market_state.get_restaurant(store_id);
-        if (!store) continue;
-        
-        float distance = calculate_distance(
-            customer.latitude, customer.longitude,
-            store->latitude, store->longitude
-        );
-        if (distance > MAX_TRAVEL_DISTANCE) continue;
-        
-        float base_score = customer.calculate_store_score(*store);
+    for (size_t i = 0; i < available.size(); i++) {
+        int slot = available[i];
+        float base_score = base_scores[i];
         
         // COMPONENT 1: Satisfaction bonus
-        float satisfaction_bonus = 0.0f;
-        if (customer.segment == "premium" && store->get_rating() >= 4.0f) {
-            satisfaction_bonus = 0.5f;
-        } else if (customer.segment == "budget" && 
-                   store->price_per_bag <= customer.willingness_to_pay) {
-            satisfaction_bonus = 0.4f;
-        } else if (customer.segment == "regular" && store->get_rating() >= 3.8f) {
-            satisfaction_bonus = 0.3f;
+        bool segment_satisfied = false;
+        if (customer.segment == CustomerSegment::PREMIUM) {
+            segment_satisfied = stores.rating[slot] >= 4.0f;
+        } else if (customer.segment == CustomerSegment::BUDGET) {
+            segment_satisfied = stores.price_per_bag[slot] <= customer.willingness_to_pay;
+        } else if (customer.segment == CustomerSegment::REGULAR) {
+            segment_satisfied = stores.rating[slot] >= 3.8f;
         }
+        float satisfaction_bonus = segment_satisfied ? segment_params.satisfaction_bonus : 0.0f;
         
         // History bonus
-        auto hist_it = customer.history.store_interactions.find(store_id);
-        if (hist_it != customer.history.store_interactions.end() && 
-            hist_it->second.successes > 0) {
-            float success_rate = (float)hist_it->second.successes / hist_it->second.reservations;
+        const StoreInteraction* interaction = customer.history.store_interactions.find(slot);
+        if (interaction && interaction->successes > 0) {
+            float success_rate = (float)interaction->successes / interaction->reservations;
             satisfaction_bonus += success_rate * 0.3f;
         }
         
         // COMPONENT 2: Waste reduction
-        int unsold_bags = max(0, store->estimated_bags - store->reserved_count);
+        int unsold_bags = stores.unsold_bags(slot);
         float waste_bonus = unsold_bags * 0.08f;
         if (unsold_bags > 12) {
             waste_bonus += 0.6f;
         }
         
         // COMPONENT 3: Fairness
-        int impressions = market_state.impression_counts[store_id];
+        int impressions = market_state.get_impressions(slot);
         float fairness_boost = 0.0f;
         
         if (impressions < avg_impressions * 0.5f) {
@@ -536,105 +535,98 @@ vector<int> get_displayed_stores_harmony(const Customer& customer,
         }
         
         // COMPONENT 4: Revenue potential
-        float inventory_safety = min(1.0f, (float)store->estimated_bags / 10.0f);
-        float revenue_bonus = (store->price_per_bag / 100.0f) * inventory_safety * 0.3f;
+        float inventory_safety = min(1.0f, (float)stores.estimated_bags[slot] / 10.0f);
+        float revenue_bonus = (stores.price_per_bag[slot] / 100.0f) * inventory_safety * 0.3f;
         
         // COMPONENT 5: Quality assurance
         float quality_penalty = 0.0f;
-        if (store->estimated_bags < 5) {
+        if (stores.estimated_bags[slot] < 5) {
             quality_penalty = -1.5f;
         }
         
         float final_score = base_score + satisfaction_bonus + waste_bonus + 
                            fairness_boost + revenue_bonus + quality_penalty;
         
-        store_scores.push_back({store_id, final_score});
+        store_scores.offer(slot, final_score);
+        
+        if (unsold_bags >= 10) {
+            high_waste_stores.offer(slot, final_score);
+        }
+        
+        bool is_new = (!interaction || interaction->reservations == 0);
+        if (is_new && stores.rating[slot] >= 3.8f && stores.estimated_bags[slot] >= 6) {
+            discovery_stores.offer(slot, final_score);
+        }
     }
-    
-    sort(store_scores.begin(), store_scores.end(),
-        [](const pair<int, float>& a, const pair<int, float>& b) {
-            return a.second > b.second;
-        });
+    const vector<pair<int, float>>& ranked = store_scores.sorted();
     
     // STEP 2: Fill top 70% slots strictly by score
-    int direct_slots = (int)(n_displayed * 0.7f);
-    for (int i = 0; i < direct_slots && i < (int)store_scores.size(); i++) {
-        int store_id = store_scores[i].first;
-        result.push_back(store_id);
-        selected.insert(store_id);
+    for (int i = 0; i < direct_slots && i < (int)ranked.size(); i++) {
+        int slot = ranked[i].first;
+        result.push_back(slot);
+        selected.assign(slot, true);
     }
     
     // STEP 3: Add one high-waste store
     if (result.size() < n_displayed) {
-        for (const auto& pair : store_scores) {
-            if (selected.find(pair.first) != selected.end()) continue;
-            
-            const Restaurant* store = market_state.get_restaurant(pair.first);
-            if (store) {
-                int unsold = max(0, store->estimated_bags - store->reserved_count);
-                if (unsold >= 10) {
-                    result.push_back(pair.first);
-                    selected.insert(pair.first);
-                    break;
-                }
-            }
+        for (const auto& pair : high_waste_stores.sorted()) {
+            if (selected.test(pair.first)) continue;
+            result.push_back(pair.first);
+            selected.assign(pair.first, true);
+            break;
         }
     }
     
     // STEP 4: Add one discovery store
     if (result.size() < n_displayed) {
-        for (const auto& pair : store_scores) {
-            if (selected.find(pair.first) != selected.end()) continue;
-            
-            auto hist_it = customer.history.store_interactions.find(pair.first);
-            bool is_new = (hist_it == customer.history.store_interactions.end() || 
-                          hist_it->second.reservations == 0);
-            
-            if (is_new) {
-                const Restaurant* store = market_state.get_restaurant(pair.first);
-                if (store && store->get_rating() >= 3.8f && store->estimated_bags >= 6) {
-                    result.push_back(pair.first);
-                    selected.insert(pair.first);
-                    break;
-                }
-            }
+        for (const auto& pair : discovery_stores.sorted()) {
+            if (selected.test(pair.first)) continue;
+            result.push_back(pair.first);
+            selected.assign(pair.first, true);
+            break;
         }
     }
     
     // STEP 5: Fill remaining with best available
-    for (const auto& pair : store_scores) {
+    for (const auto& pair : ranked) {
         if (result.size() >= n_displayed) break;
-        if (selected.find(pair.first) == selected.end()) {
+        if (!selected.test(pair.first)) {
             result.push_back(pair.first);
-            selected.insert(pair.first);
+            selected.assign(pair.first, true);
         }
     }
     
-    // Track impressions
-    for (int store_id : result) {
-        market_state.impression_counts[store_id]++;
-    }
-    
-    return result;
+    // Impressions are recorded once per arrival by the decision step
+    context.set_slate(result.data(), result.size(), customer, stores);
+    return context.slate_ids;
 }
 
 // Dispatch function
-vector<int> get_displayed_stores(const Customer& customer,
-                                      MarketState& market_state,
+const vector<int>& get_displayed_stores(const Customer& customer,
+                                      const MarketState& market_state,
                                       int n_displayed,
-                                      RankingAlgorithm algorithm) {
+                                      RankingAlgorithm algorithm,
+                                      ArrivalContext& context) {
     if (algorithm == RankingAlgorithm::SAMA) {
-        return get_displayed_stores_sama(customer, market_state, n_displayed);
+        return get_displayed_stores_sama(customer, market_state, n_displayed, context);
     } else if (algorithm == RankingAlgorithm::ANDREW) {
-        return get_displayed_stores_andrew(customer, market_state, n_displayed);
+        return get_displayed_stores_andrew(customer, market_state, n_displayed, context);
     } else if (algorithm == RankingAlgorithm::AMER) {
-        return get_displayed_stores_amer(customer, market_state, n_displayed);
+        return get_displayed_stores_amer(customer, market_state, n_displayed, context);
     } else if (algorithm == RankingAlgorithm::ZIAD) {
-        return get_displayed_stores_ziad(customer, market_state, n_displayed);
+        return get_displayed_stores_ziad(customer, market_state, n_displayed, context);
     } else if (algorithm == RankingAlgorithm::HARMONY) {
-        return get_displayed_stores_harmony(customer, market_state, n_displayed);
+        return get_displayed_stores_harmony(customer, market_state, n_displayed, context);
     } else {
-        return get_displayed_stores_baseline(customer, market_state, n_displayed);
+        return get_displayed_stores_baseline(customer, market_state, n_displayed, context);
     }
 }
 
+// Convenience form that only returns the slate's store IDs
+vector<int> get_displayed_stores(const Customer& customer,
+                                      const MarketState& market_state,
+                                      int n_displayed,
+                                      RankingAlgorithm algorithm) {
+    ArrivalContext context;
+    return get_displayed_stores(customer, market_state, n_displayed, algorithm, context);
+}
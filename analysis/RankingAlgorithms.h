@@ -4,6 +4,7 @@
 #include <vector>
 #include "Customer.h"
 #include "MarketState.h"
+#include "ArrivalContext.h"
 
 using namespace std;
 
@@ -18,38 +19,53 @@ enum class RankingAlgorithm {
 };
 
 // Baseline: Top-rated stores
-vector<int> get_displayed_stores_baseline(const Customer& customer,
+const vector<int>& get_displayed_stores_baseline(const Customer& customer,
                                                 const MarketState& market_state,
-                                                int n_displayed);
+                                                int n_displayed,
+                                                ArrivalContext& context);
 
 // Sama: Personalized + Waste Reduction
-vector<int> get_displayed_stores_sama(const Customer& customer,
+const vector<int>& get_displayed_stores_sama(const Customer& customer,
                                            const MarketState& market_state,
-                                           int n_displayed);
+                                           int n_displayed,
+                                           ArrivalContext& context);
 
 // Ziad: Weighted Score (Price, Rating, Unsold)
-vector<int> get_displayed_stores_ziad(const Customer& customer,
+const vector<int>& get_displayed_stores_ziad(const Customer& customer,
                                             const MarketState& market_state,
-                                            int n_displayed);
+                                            int n_displayed,
+                                            ArrivalContext& context);
 
 // Andrew: Fairness (Impression Counts)
-vector<int> get_displayed_stores_andrew(const Customer& customer,
-                                             MarketState& market_state,
-                                             int n_displayed);
+const vector<int>& get_displayed_stores_andrew(const Customer& customer,
+                                             const MarketState& market_state,
+                                             int n_displayed,
+                                             ArrivalContext& context);
 
 // Amer: Closest Store Guarantee
-vector<int> get_displayed_stores_amer(const Customer& customer,
+const vector<int>& get_displayed_stores_amer(const Customer& customer,
                                            const MarketState& market_state,
-                                           int n_displayed);
+                                           int n_displayed,
+                                           ArrivalContext& context);
 
 // Harmony: Unified Strategy
-vector<int> get_displayed_stores_harmony(const Customer& customer,
-                                              MarketState& market_state,
-                                              int n_displayed);
+const vector<int>& get_displayed_stores_harmony(const Customer& customer,
+                                              const MarketState& market_state,
+                                              int n_displayed,
+                                              ArrivalContext& context);
 
 // Dispatcher function
+// Each ranking fills the context (candidates, slate, base scores) and
+// returns a reference to its slate_ids
+const vector<int>& get_displayed_stores(const Customer& customer,
+                                      const MarketState& market_state,
+                                      int n_displayed,
+                                      RankingAlgorithm algorithm,
+                                      ArrivalContext& context);
+
+// Dispatcher returning only the store IDs (uses a throwaway context)
 vector<int> get_displayed_stores(const Customer& customer,
-                                      MarketState& market_state,
+                                      const MarketState& market_state,
                                       int n_displayed,
                                       RankingAlgorithm algorithm = RankingAlgorithm::BASELINE);
 
@@ -0,0 +1,49 @@
+#include "RankingWorkspace.h"
+
+using namespace std;
+
+SlateBuffer::SlateBuffer() : slots(inline_slots), count(0), capacity(INLINE_CAPACITY) {}
+
+void SlateBuffer::reset(int new_capacity, ScratchArena& arena) {
+    count = 0;
+    if (new_capacity <= INLINE_CAPACITY) {
+        slots = inline_slots;
+        capacity = INLINE_CAPACITY;
+    } else {
+        slots = arena.allocate<int>(new_capacity);
+        capacity = new_capacity;
+    }
+}
+
+void SlateBuffer::push_back(int slot) {
+    if (count < capacity) {
+        slots[count++] = slot;
+    }
+}
+
+int SlateBuffer::size() const {
+    return count;
+}
+
+int SlateBuffer::operator[](int i) const {
+    return slots[i];
+}
+
+const int* SlateBuffer::data() const {
+    return slots;
+}
+
+void RankingWorkspace::begin_arrival(int num_stores, int n_displayed) {
+    arena.reset();
+    if (selected.size() != num_stores) {
+        selected.reset(num_stores);
+    } else {
+        selected.clear();
+    }
+    slate.reset(n_displayed, arena);
+}
+
+RankingWorkspace& ranking_workspace() {
+    static thread_local RankingWorkspace workspace;
+    return workspace;
+}
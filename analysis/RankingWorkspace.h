@@ -0,0 +1,60 @@
+#ifndef RANKING_WORKSPACE_H
+#define RANKING_WORKSPACE_H
+
+#include <vector>
+#include "ScratchArena.h"
+#include "SlotBitset.h"
+#include "TopKSelector.h"
+#include "StoreScoring.h"
+
+using namespace std;
+
+// Slate Buffer
+// The slate under construction. Up to INLINE_CAPACITY slots live inside the
+// buffer itself; larger slates take their storage from the scratch arena.
+class SlateBuffer {
+public:
+    static const int INLINE_CAPACITY = 32;
+
+    SlateBuffer();
+
+    // Empty the buffer and make room for up to capacity slots
+    void reset(int capacity, ScratchArena& arena);
+
+    void push_back(int slot);
+    int size() const;
+    int operator[](int i) const;
+    const int* data() const;
+
+private:
+    int inline_slots[INLINE_CAPACITY];
+    int* slots;
+    int count;
+    int capacity;
+};
+
+// Ranking Workspace
+// Scratch state reused by every ranking call on a thread, so steady-state
+// arrivals allocate nothing: the containers below keep their capacity
+// between arrivals and the arena is rewound instead of freed.
+struct RankingWorkspace {
+    ScratchArena arena;
+    SlotBitset selected;             // stores already placed on the slate
+    SlateBuffer slate;
+
+    // Selectors for the main ranking and the single-store picks
+    TopKSelector ranking;
+    TopKSelector pick_a;
+    TopKSelector pick_b;
+
+    vector<int> reachable;           // spatial query results
+    CustomerScoringParams scoring;
+
+    // Prepare for one ranking call
+    void begin_arrival(int num_stores, int n_displayed);
+};
+
+// Workspace for the calling thread
+RankingWorkspace& ranking_workspace();
+
+#endif // RANKING_WORKSPACE_H
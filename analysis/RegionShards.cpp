@@ -0,0 +1,121 @@
+#include "RegionShards.h"
+#include <algorithm>
+
+using namespace std;
+
+// Link radius slack so float rounding never splits stores a customer
+// could reach both of (joining extra stores only costs parallelism)
+static const float LINK_SLACK = 1.01f;
+
+bool supports_region_shards(RankingAlgorithm algorithm) {
+    return algorithm == RankingAlgorithm::AMER || algorithm == RankingAlgorithm::ZIAD;
+}
+
+// Union-find root with path halving
+static int find_root(vector<int>& parent, int slot) {
+    while (parent[slot] != slot) {
+        parent[slot] = parent[parent[slot]];
+        slot = parent[slot];
+    }
+    return slot;
+}
+
+vector<int> find_store_regions(const MarketState& market_state, int& region_count) {
+    const StoreTable& stores = market_state.get_store_table();
+    int n = stores.size();
+    float link = 2.0f * market_state.get_travel_distance() * LINK_SLACK;
+
+    vector<int> parent(n);
+    for (int slot = 0; slot < n; slot++) {
+        parent[slot] = slot;
+    }
+
+    // Join every store with its neighbours; the lower root wins so the
+    // region numbering below does not depend on query order
+    vector<int> neighbours;
+    for (int slot = 0; slot < n; slot++) {
+        neighbours.clear();
+        market_state.get_spatial_index().query_radius(stores.latitude[slot], stores.longitude[slot],
+                                                      link, neighbours);
+        for (int other : neighbours) {
+            int a = find_root(parent, slot);
+            int b = find_root(parent, other);
+            if (a != b) {
+                parent[max(a, b)] = min(a, b);
+            }
+        }
+    }
+
+    vector<int> region(n, -1);
+    region_count = 0;
+    for (int slot = 0; slot < n; slot++) {
+        int root = find_root(parent, slot);
+        if (region[root] == -1) {
+            region[root] = region_count++;
+        }
+        region[slot] = region[root];
+    }
+    return region;
+}
+
+vector<vector<int>> shard_arrivals(const vector<Customer>& customers,
+                                   const MarketState& market_state,
+                                   int shard_count, vector<int>& store_shard) {
+    int region_count = 0;
+    vector<int> store_region = find_store_regions(market_state, region_count);
+    shard_count = max(shard_count, 1);
+
+    // Region of each customer: that of any store in reach (-1 if none)
+    float reach = market_state.get_travel_distance();
+    vector<int> customer_region(customers.size(), -1);
+    vector<int> region_load(region_count, 0);
+    for (size_t i = 0; i < customers.size(); i++) {
+        int slot = market_state.get_spatial_index().nearest(
+            customers[i].latitude, customers[i].longitude, reach,
+            [](int) { return true; });
+        if (slot != -1) {
+            customer_region[i] = store_region[slot];
+            region_load[customer_region[i]]++;
+        }
+    }
+
+    // Busiest regions first, each onto the lightest shard so far
+    vector<int> order;
+    for (int region = 0; region < region_count; region++) {
+        if (region_load[region] > 0) order.push_back(region);
+    }
+    stable_sort(order.begin(), order.end(),
+        [&region_load](int a, int b) { return region_load[a] > region_load[b]; });
+
+    vector<int> shard_load(shard_count, 0);
+    vector<int> region_shard(region_count, -1);
+    for (int region : order) {
+        int shard = (int)(min_element(shard_load.begin(), shard_load.end()) - shard_load.begin());
+        region_shard[region] = shard;
+        shard_load[shard] += region_load[region];
+    }
+
+    // Customers with no store in reach only churn; they fill the gaps
+    vector<vector<int>> shards(shard_count);
+    for (size_t i = 0; i < customers.size(); i++) {
+        int shard;
+        if (customer_region[i] != -1) {
+            shard = region_shard[customer_region[i]];
+        } else {
+            shard = (int)(min_element(shard_load.begin(), shard_load.end()) - shard_load.begin());
+            shard_load[shard]++;
+        }
+        shards[shard].push_back((int)i);
+    }
+
+    // The lightest shard is always filled first, so empty ones trail
+    while (!shards.empty() && shards.back().empty()) {
+        shards.pop_back();
+    }
+
+    store_shard.assign(store_region.size(), -1);
+    for (size_t slot = 0; slot < store_region.size(); slot++) {
+        store_shard[slot] = region_shard[store_region[slot]];
+    }
+    return shards;
+}
@@ -0,0 +1,35 @@
+#ifndef REGION_SHARDS_H
+#define REGION_SHARDS_H
+
+#include <vector>
+#include "Customer.h"
+#include "MarketState.h"
+#include "RankingAlgorithms.h"
+
+using namespace std;
+
+// Region Shards
+// A customer only buys from stores within the travel distance, so two
+// stores more than twice that distance apart can never be offered to the
+// same customer. Stores closer than that are joined into one region (the
+// halo around each store pulls in every neighbour a border customer could
+// also reach), which leaves every customer's reachable stores inside a
+// single region. Regions therefore run their arrivals independently, and
+// are packed into shards of similar load for the worker threads.
+
+// Only algorithms whose slate depends on the stores in reach alone can be
+// sharded. BASELINE, SAMA and ANDREW rank the whole catalog and HARMONY
+// reads market-wide impression and inventory totals.
+bool supports_region_shards(RankingAlgorithm algorithm);
+
+// Region per slot, numbered 0..region_count-1 by lowest slot
+vector<int> find_store_regions(const MarketState& market_state, int& region_count);
+
+// Split arrivals (indexes into customers, arrival order kept within each
+// shard) into at most shard_count non-empty shards. store_shard receives
+// the shard owning each slot, -1 for stores no arriving customer can reach.
+vector<vector<int>> shard_arrivals(const vector<Customer>& customers,
+                                   const MarketState& market_state,
+                                   int shard_count, vector<int>& store_shard);
+
+#endif // REGION_SHARDS_H
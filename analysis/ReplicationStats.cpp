@@ -0,0 +1,164 @@
+#include "ReplicationStats.h"
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+SummaryStats::SummaryStats() : n(0), mean(0.0), std_error(0.0), ci_low(0.0), ci_high(0.0) {}
+
+double SummaryStats::margin() const {
+    return (ci_high - ci_low) / 2.0;
+}
+
+bool SummaryStats::excludes_zero() const {
+    return n > 1 && (ci_low > 0.0 || ci_high < 0.0);
+}
+
+double t_critical_95(int df) {
+    static const double TABLE[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df <= 0) return 0.0;
+    if (df <= 30) return TABLE[df - 1];
+    if (df <= 40) return 2.021;
+    if (df <= 60) return 2.000;
+    if (df <= 120) return 1.980;
+    return 1.960;
+}
+
+SummaryStats summarize(const vector<double>& samples) {
+    SummaryStats s;
+    s.n = (int)samples.size();
+    if (s.n == 0) return s;
+
+    double sum = 0.0;
+    for (double x : samples) sum += x;
+    s.mean = sum / s.n;
+
+    // With a single sample there is no spread estimate; the interval collapses
+    if (s.n > 1) {
+        double squares = 0.0;
+        for (double x : samples) squares += (x - s.mean) * (x - s.mean);
+        s.std_error = sqrt(squares / (s.n - 1)) / sqrt((double)s.n);
+    }
+    double margin = t_critical_95(s.n - 1) * s.std_error;
+    s.ci_low = s.mean - margin;
+    s.ci_high = s.mean + margin;
+    return s;
+}
+
+static double revenue_efficiency(const SimulationMetrics& m) {
+    double total = m.total_revenue_generated + m.total_revenue_lost;
+    return total > 0 ? m.total_revenue_generated / total * 100.0 : 0.0;
+}
+
+static double conversion_rate(const SimulationMetrics& m) {
+    return m.total_customer_arrivals > 0 ?
+        (double)(m.total_customer_arrivals - m.customers_who_left) / m.total_customer_arrivals * 100.0 : 0.0;
+}
+
+static double bags_sold(const SimulationMetrics& m) { return m.total_bags_sold; }
+static double bags_cancelled(const SimulationMetrics& m) { return m.total_bags_cancelled; }
+static double bags_unsold(const SimulationMetrics& m) { return m.total_bags_unsold; }
+static double revenue_generated(const SimulationMetrics& m) { return m.total_revenue_generated; }
+static double revenue_lost(const SimulationMetrics& m) { return m.total_revenue_lost; }
+static double customers_left(const SimulationMetrics& m) { return m.customers_who_left; }
+static double gini(const SimulationMetrics& m) { return m.gini_coefficient_exposure; }
+
+const vector<ReportedMetric>& reported_metrics() {
+    static const vector<ReportedMetric> metrics = {
+        {"Bags Sold", "bags_sold", bags_sold, 2},
+        {"Bags Cancelled", "bags_cancelled", bags_cancelled, 2},
+        {"Bags Unsold (Waste)", "bags_unsold", bags_unsold, 2},
+        {"Revenue Generated ($)", "revenue_generated", revenue_generated, 2},
+        {"Revenue Lost ($)", "revenue_lost", revenue_lost, 2},
+        {"Revenue Efficiency (%)", "revenue_efficiency_pct", revenue_efficiency, 2},
+        {"Customers Who Left", "customers_left", customers_left, 2},
+        {"Conversion Rate (%)", "conversion_rate_pct", conversion_rate, 2},
+        {"Gini Coefficient (Fairness)", "gini_exposure", gini, 4}
+    };
+    return metrics;
+}
+
+// "mean +/- margin" in a fixed-width column
+static string format_estimate(const SummaryStats& s, int precision) {
+    ostringstream cell;
+    cell << fixed << setprecision(precision) << s.mean << " +/- " << s.margin();
+    return cell.str();
+}
+
+static vector<double> metric_samples(const vector<SimulationMetrics>& runs, const ReportedMetric& metric) {
+    vector<double> samples;
+    for (const auto& m : runs) {
+        samples.push_back(metric.value(m));
+    }
+    return samples;
+}
+
+void write_replication_summary(ostream& out,
+                               const vector<string>& algorithm_names,
+                               const vector<vector<SimulationMetrics>>& runs) {
+    const vector<ReportedMetric>& metrics = reported_metrics();
+    int num_algorithms = (int)algorithm_names.size();
+    int replications = runs.empty() ? 0 : (int)runs[0].size();
+    int width = 35 + 24 * num_algorithms;
+
+    out << string(width, '=') << "\n";
+    out << "REPLICATED RESULTS (" << replications << " seeds)\n";
+    out << string(width, '=') << "\n\n";
+
+    out << "Mean +/- 95% CI half-width across replications\n";
+    out << string(width, '-') << "\n";
+    out << left << setw(35) << "Metric";
+    for (const auto& name : algorithm_names) {
+        out << setw(24) << name;
+    }
+    out << "\n" << string(width, '-') << "\n";
+    for (const auto& metric : metrics) {
+        out << left << setw(35) << metric.name;
+        for (int a = 0; a < num_algorithms; a++) {
+            out << setw(24) << format_estimate(summarize(metric_samples(runs[a], metric)), metric.precision);
+        }
+        out << "\n";
+    }
+    out << "\n";
+
+    out << "Standard error of the mean\n";
+    out << string(width, '-') << "\n";
+    for (const auto& metric : metrics) {
+        out << left << setw(35) << metric.name;
+        for (int a = 0; a < num_algorithms; a++) {
+            SummaryStats s = summarize(metric_samples(runs[a], metric));
+            out << fixed << setprecision(metric.precision) << setw(24) << s.std_error;
+        }
+        out << "\n";
+    }
+    out << "\n";
+
+    // Paired differences, B - A per seed; * marks intervals that exclude 0
+    out << string(width, '=') << "\n";
+    out << "PAIRED DIFFERENCES (B - A, mean +/- 95% CI, * = significant)\n";
+    out << string(width, '=') << "\n";
+    for (const auto& metric : metrics) {
+        out << "\n" << metric.name << "\n";
+        for (int a = 0; a < num_algorithms; a++) {
+            for (int b = a + 1; b < num_algorithms; b++) {
+                vector<double> diffs;
+                for (int r = 0; r < replications; r++) {
+                    diffs.push_back(metric.value(runs[b][r]) - metric.value(runs[a][r]));
+                }
+                SummaryStats s = summarize(diffs);
+                string pair_label = "  " + algorithm_names[b] + " - " + algorithm_names[a];
+                out << left << setw(35) << pair_label
+                    << fixed << setprecision(metric.precision)
+                    << (s.mean >= 0 ? "+" : "") << s.mean << " +/- " << s.margin()
+                    << "  [" << s.ci_low << ", " << s.ci_high << "]"
+                    << (s.excludes_zero() ? " *" : "") << "\n";
+            }
+        }
+    }
+    out << string(width, '=') << "\n";
+}
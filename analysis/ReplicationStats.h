@@ -0,0 +1,54 @@
+#ifndef REPLICATION_STATS_H
+#define REPLICATION_STATS_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include "Metrics.h"
+
+using namespace std;
+
+// Replication Statistics
+// Summaries over R independent replications (seeds) of the same scenario.
+// All algorithms in a replication see the same customers and arrivals, so
+// algorithm pairs are compared on per-seed differences (paired samples),
+// which cancels most of the seed-to-seed noise.
+
+// Mean with its standard error and 95% confidence interval (Student t)
+struct SummaryStats {
+    int n;
+    double mean;
+    double std_error;
+    double ci_low;
+    double ci_high;
+
+    SummaryStats();
+
+    // Half-width of the confidence interval
+    double margin() const;
+    // True when the interval excludes zero
+    bool excludes_zero() const;
+};
+
+SummaryStats summarize(const vector<double>& samples);
+
+// Two-sided 95% Student t critical value for the given degrees of freedom
+double t_critical_95(int degrees_of_freedom);
+
+// A report row: one scalar taken from SimulationMetrics
+struct ReportedMetric {
+    const char* name;
+    const char* key;    // CSV column name
+    double (*value)(const SimulationMetrics& m);
+    int precision;
+};
+
+// Metrics shown in the comparison report, in report order
+const vector<ReportedMetric>& reported_metrics();
+
+// runs[a][r] holds the metrics of algorithm a in replication r
+void write_replication_summary(ostream& out,
+                               const vector<string>& algorithm_names,
+                               const vector<vector<SimulationMetrics>>& runs);
+
+#endif // REPLICATION_STATS_H
@@ -1,5 +1,6 @@
 #include "Restaurant.h"
 #include <algorithm>
+#include "Categories.h"
 
 using namespace std;
 
@@ -10,7 +11,7 @@ Restaurant::Restaurant(int id, const string& name, const string& branch_name,
     : business_id(id), business_name(name), branch(branch_name),
       estimated_bags(est_bags), general_ranking(rating), price_per_bag(price),
       longitude(lon), latitude(lat), business_type(type),
-      actual_bags(0), reserved_count(0), has_inventory(true),
+      category_id(intern_category(type)), actual_bags(0), reserved_count(0), has_inventory(true),
       max_bags_per_customer(3), total_orders_confirmed(0),
       total_orders_cancelled(0), initial_rating(rating),
       rating_at_day_start(rating), daily_orders_confirmed(0),
@@ -23,7 +24,7 @@ Restaurant::Restaurant(int id, const string& name, float rating,
     : business_id(id), business_name(name), branch(""),
       estimated_bags(est_bags), general_ranking(rating), price_per_bag(price),
       longitude(0.0f), latitude(0.0f), business_type(type),
-      actual_bags(0), reserved_count(0), has_inventory(true),
+      category_id(intern_category(type)), actual_bags(0), reserved_count(0), has_inventory(true),
       max_bags_per_customer(3), total_orders_confirmed(0),
       total_orders_cancelled(0), initial_rating(rating),
       rating_at_day_start(rating), daily_orders_confirmed(0),
@@ -20,6 +20,7 @@ public:
 
     // Additional Properties
     string business_type;
+    int category_id;          // interned business_type
     int actual_bags;
     int reserved_count;
     bool has_inventory;
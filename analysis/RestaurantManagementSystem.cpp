@@ -4,71 +4,97 @@
 using namespace std;
 
 void RestaurantManagementSystem::process_end_of_day(MarketState& market_state) {
-    for (auto& restaurant : market_state.restaurants) {
-        vector<Reservation*> restaurant_reservations;
-        for (auto& res : market_state.reservations) {
-            if (res.restaurant_id == restaurant.business_id &&
-                res.status == Reservation::PENDING) {
-                restaurant_reservations.push_back(&res);
+    vector<vector<int>> pending;
+    pending_by_slot(market_state, pending);
+
+    vector<pair<int, int>> outcomes;
+    for (int slot = 0; slot < market_state.get_restaurant_count(); slot++) {
+        outcomes.clear();
+        settle_store(market_state, slot, pending[slot], outcomes);
+        for (const auto& outcome : outcomes) {
+            Reservation& res = market_state.reservations[outcome.first];
+            Customer* customer = market_state.get_customer(res.customer_id);
+            if (outcome.second > 0) {
+                handle_confirmation(res, *customer, market_state, outcome.second);
+            } else {
+                handle_cancellation(res, *customer, market_state);
             }
         }
+    }
+}
 
-        // Process reservations in order of time
-        sort(restaurant_reservations.begin(), restaurant_reservations.end(),
-            [](Reservation* a, Reservation* b) {
-                return a->reservation_time < b->reservation_time;
-            });
+// One pass over the reservations instead of one per store
+void RestaurantManagementSystem::pending_by_slot(const MarketState& market_state,
+                                                 vector<vector<int>>& buckets) {
+    buckets.assign(market_state.get_restaurant_count(), vector<int>());
+    for (int i = 0; i < (int)market_state.reservations.size(); i++) {
+        const Reservation& res = market_state.reservations[i];
+        int slot = market_state.get_restaurant_slot(res.restaurant_id);
+        if (slot >= 0 && res.status == Reservation::PENDING) {
+            buckets[slot].push_back(i);
+        }
+    }
+}
 
-        int num_reservations = restaurant_reservations.size();
-        int actual_bags = restaurant.actual_bags;
+void RestaurantManagementSystem::settle_store(MarketState& market_state, int slot,
+                                              vector<int>& restaurant_reservations,
+                                              vector<pair<int, int>>& outcomes) {
+    const Restaurant& restaurant = market_state.restaurant_at(slot);
+    const vector<Reservation>& reservations = market_state.reservations;
 
-        if (num_reservations == 0) {
-            continue;
-        }
+    // Process reservations in order of time
+    sort(restaurant_reservations.begin(), restaurant_reservations.end(),
+        [&reservations](int a, int b) {
+            return reservations[a].reservation_time < reservations[b].reservation_time;
+        });
 
-        if (actual_bags >= num_reservations) {
-            // Enough bags for everyone
-            int remaining_bags = actual_bags;
-            int bags_per_customer = min(
-                restaurant.max_bags_per_customer,
-                remaining_bags / num_reservations
-            );
-            
-            int extra_bags = remaining_bags - (bags_per_customer * num_reservations);
+    int num_reservations = restaurant_reservations.size();
+    int actual_bags = restaurant.actual_bags;
+
+    if (num_reservations == 0) {
+        return;
+    }
+
+    if (actual_bags >= num_reservations) {
+        // Enough bags for everyone
+        int remaining_bags = actual_bags;
+        int bags_per_customer = min(
+            restaurant.max_bags_per_customer,
+            remaining_bags / num_reservations
+        );
+        
+        int extra_bags = remaining_bags - (bags_per_customer * num_reservations);
+        
+        for (size_t i = 0; i < restaurant_reservations.size(); i++) {
+            int res = restaurant_reservations[i];
+            Customer* customer = market_state.get_customer(reservations[res].customer_id);
             
-            for (size_t i = 0; i < restaurant_reservations.size(); i++) {
-                Reservation* res = restaurant_reservations[i];
-                Customer* customer = market_state.get_customer(res->customer_id);
-                
-                if (customer) {
-                    int bags_for_this_customer = bags_per_customer;
-                    // Distribute extra bags to first customers if possible
-                    if (extra_bags > 0 && bags_for_this_customer < restaurant.max_bags_per_customer) {
-                        bags_for_this_customer++;
-                        extra_bags--;
-                    }
-                    
-                    handle_confirmation(*res, *customer, market_state, bags_for_this_customer);
+            if (customer) {
+                int bags_for_this_customer = bags_per_customer;
+                // Distribute extra bags to first customers if possible
+                if (extra_bags > 0 && bags_for_this_customer < restaurant.max_bags_per_customer) {
+                    bags_for_this_customer++;
+                    extra_bags--;
                 }
+                
+                outcomes.push_back(make_pair(res, bags_for_this_customer));
             }
-        } else {
-            // Not enough bags for everyone (some get bags, others get cancelled)
-            // First customers get 1 bag each until stock runs out
-            for (int i = 0; i < actual_bags; i++) {
-                Reservation* res = restaurant_reservations[i];
-                Customer* customer = market_state.get_customer(res->customer_id);
-                if (customer) {
-                    handle_confirmation(*res, *customer, market_state, 1);
-                }
+        }
+    } else {
+        // Not enough bags for everyone (some get bags, others get cancelled)
+        // First customers get 1 bag each until stock runs out
+        for (int i = 0; i < actual_bags; i++) {
+            int res = restaurant_reservations[i];
+            if (market_state.get_customer(reservations[res].customer_id)) {
+                outcomes.push_back(make_pair(res, 1));
             }
-            
-            // Remaining reservations are cancelled
-            for (int i = actual_bags; i < num_reservations; i++) {
-                Reservation* res = restaurant_reservations[i];
-                Customer* customer = market_state.get_customer(res->customer_id);
-                if (customer) {
-                    handle_cancellation(*res, *customer, market_state);
-                }
+        }
+        
+        // Remaining reservations are cancelled
+        for (int i = actual_bags; i < num_reservations; i++) {
+            int res = restaurant_reservations[i];
+            if (market_state.get_customer(reservations[res].customer_id)) {
+                outcomes.push_back(make_pair(res, 0));
             }
         }
     }
@@ -78,11 +104,12 @@ void RestaurantManagementSystem::handle_cancellation(Reservation& reservation,
                                                       Customer& customer, 
                                                       MarketState& market_state) {
     reservation.status = Reservation::CANCELLED;
-    customer.record_reservation_cancellation(reservation.restaurant_id);
+    int slot = market_state.get_restaurant_slot(reservation.restaurant_id);
+    customer.record_reservation_cancellation(slot);
     
-    Restaurant* restaurant = market_state.get_restaurant(reservation.restaurant_id);
-    if (restaurant) {
-        restaurant->update_rating_on_cancellation();
+    if (slot >= 0) {
+        market_state.restaurant_at(slot).update_rating_on_cancellation();
+        market_state.refresh_store(slot);
     }
 }
 
@@ -92,11 +119,12 @@ void RestaurantManagementSystem::handle_confirmation(Reservation& reservation,
                                                       int bags_received) {
     reservation.status = Reservation::CONFIRMED;
     reservation.bags_received = bags_received;  // Track bags given to customer
-    customer.record_reservation_success(reservation.restaurant_id, "");
+    int slot = market_state.get_restaurant_slot(reservation.restaurant_id);
+    customer.record_reservation_success(slot, -1);
     
-    Restaurant* restaurant = market_state.get_restaurant(reservation.restaurant_id);
-    if (restaurant) {
-        restaurant->update_rating_on_confirmation();
+    if (slot >= 0) {
+        market_state.restaurant_at(slot).update_rating_on_confirmation();
+        market_state.refresh_store(slot);
     }
 }
 
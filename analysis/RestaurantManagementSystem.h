@@ -1,6 +1,8 @@
 #ifndef RESTAURANT_MANAGEMENT_SYSTEM_H
 #define RESTAURANT_MANAGEMENT_SYSTEM_H
 
+#include <vector>
+#include <utility>
 #include "MarketState.h"
 #include "Reservation.h"
 #include "Customer.h"
@@ -21,6 +23,20 @@ public:
     // 3. Shortage -> confirm first-come-first-served, cancel excess
     static void process_end_of_day(MarketState& market_state);
 
+    // Pending reservations (indexes into market_state.reservations) grouped
+    // by store slot, in reservation order. Indexes stay valid when later
+    // reservations grow the vector.
+    static void pending_by_slot(const MarketState& market_state,
+                                vector<vector<int>>& buckets);
+
+    // Decide one store's settlement without applying it. pending is sorted
+    // by time; outcomes receive (reservation index, bags) in serving order,
+    // with 0 bags for a cancellation. Reservations of unknown customers stay
+    // pending.
+    static void settle_store(MarketState& market_state, int slot,
+                             vector<int>& pending,
+                             vector<pair<int, int>>& outcomes);
+
     // Handle reservation cancellation
     // Updates customer history and restaurant rating
     static void handle_cancellation(Reservation& reservation, 
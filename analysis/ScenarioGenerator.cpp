@@ -0,0 +1,186 @@
+#include "ScenarioGenerator.h"
+#include "RandomStream.h"
+#include "ThreadPool.h"
+#include "Segments.h"
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+using namespace std;
+
+static const int STORES_PER_NEIGHBOURHOOD = 100;
+static const int ITEMS_PER_TASK = 4096;
+
+// Smallest half-extent, so a one-store sample still covers an area
+static const float MIN_HALF_EXTENT = 0.005f;
+
+// Relative noise on redrawn sample values
+static const float BAGS_NOISE = 0.25f;
+static const float PRICE_NOISE = 0.2f;
+static const float RATING_NOISE = 0.2f;
+static const float PREFERENCE_NOISE = 0.1f;
+
+ScenarioSpec::ScenarioSpec()
+    : store_count(1000), customer_count(10000), neighbourhoods(0),
+      spread(0.01f), area_scale(0.0f), seed(DEFAULT_SIMULATION_SEED) {}
+
+ScenarioFit fit_scenario(const vector<Restaurant>& stores, const vector<Customer>& customers) {
+    ScenarioFit fit;
+    fit.stores = stores;
+    fit.customers = customers;
+
+    // Category mix
+    for (int i = 0; i < (int)stores.size(); i++) {
+        const string& type = stores[i].business_type;
+        int category = (int)(find(fit.categories.begin(), fit.categories.end(), type) - fit.categories.begin());
+        if (category == (int)fit.categories.size()) {
+            fit.categories.push_back(type);
+            fit.stores_by_category.push_back(vector<int>());
+        }
+        fit.stores_by_category[category].push_back(i);
+    }
+    vector<float> weights;
+    for (const auto& members : fit.stores_by_category) {
+        weights.push_back((float)members.size());
+    }
+    fit.category_mix.build(weights.data(), (int)weights.size());
+
+    // Segment ratios (labels the model does not know are left out)
+    fit.customers_by_segment.assign(3, vector<int>());
+    for (int i = 0; i < (int)customers.size(); i++) {
+        int segment = (int)customers[i].segment;
+        if (segment < 3) {
+            fit.customers_by_segment[segment].push_back(i);
+        }
+    }
+    weights.assign(3, 0.0f);
+    float sampled = 0.0f;
+    for (int segment = 0; segment < 3; segment++) {
+        weights[segment] = (float)fit.customers_by_segment[segment].size();
+        sampled += weights[segment];
+    }
+    if (sampled == 0.0f) {
+        weights.assign(3, 1.0f);
+    }
+    fit.segment_mix.build(weights.data(), 3);
+
+    // Sample extent
+    float min_lat = stores.empty() ? 30.05f : stores[0].latitude, max_lat = min_lat;
+    float min_lon = stores.empty() ? 31.25f : stores[0].longitude, max_lon = min_lon;
+    for (const auto& r : stores) {
+        min_lat = min(min_lat, r.latitude);
+        max_lat = max(max_lat, r.latitude);
+        min_lon = min(min_lon, r.longitude);
+        max_lon = max(max_lon, r.longitude);
+    }
+    fit.center_lat = (min_lat + max_lat) / 2.0f;
+    fit.center_lon = (min_lon + max_lon) / 2.0f;
+    fit.half_lat = max((max_lat - min_lat) / 2.0f, MIN_HALF_EXTENT);
+    fit.half_lon = max((max_lon - min_lon) / 2.0f, MIN_HALF_EXTENT);
+    return fit;
+}
+
+// fill(begin, end) over [0, count) in fixed chunks on the pool
+static void for_each_chunk(ThreadPool& pool, int count, const function<void(int, int)>& fill) {
+    for (int begin = 0; begin < count; begin += ITEMS_PER_TASK) {
+        int end = min(begin + ITEMS_PER_TASK, count);
+        pool.submit([&fill, begin, end]() { fill(begin, end); });
+    }
+    pool.wait();
+}
+
+// base + (rng() % range) / scale, as for random customers
+static float draw(const SegmentDraw& d, RandomStream& rng) {
+    return d.base + (rng() % d.range) / d.scale;
+}
+
+Scenario generate_scenario(const ScenarioFit& fit, const ScenarioSpec& spec, int threads) {
+    Scenario scenario;
+    if (fit.stores.empty()) return scenario;
+
+    int store_count = max(spec.store_count, 0);
+    int customer_count = max(spec.customer_count, 0);
+    int areas = spec.neighbourhoods > 0 ? spec.neighbourhoods
+        : max(1, (store_count + STORES_PER_NEIGHBOURHOOD - 1) / STORES_PER_NEIGHBOURHOOD);
+    float scale = spec.area_scale > 0.0f ? spec.area_scale
+        : max(1.0f, sqrt((float)store_count / fit.stores.size()));
+
+    // Neighbourhood centres over the scaled sample area; lognormal sizes
+    // give a few dense centres and many quiet ones
+    vector<float> area_lat(areas), area_lon(areas), area_weight(areas);
+    for (int a = 0; a < areas; a++) {
+        RandomStream rng(spec.seed, StreamPurpose::SCENARIO_AREA, 0, a);
+        uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        lognormal_distribution<float> size(0.0f, 1.0f);
+        area_lat[a] = fit.center_lat + unit(rng) * fit.half_lat * scale;
+        area_lon[a] = fit.center_lon + unit(rng) * fit.half_lon * scale;
+        area_weight[a] = size(rng);
+    }
+    AliasTable area_mix;
+    area_mix.build(area_weight.data(), areas);
+
+    ThreadPool pool(threads);
+
+    scenario.stores.assign(store_count, Restaurant(0, "", "", 0, 0.0f, 0.0f, 0.0f, 0.0f));
+    for_each_chunk(pool, store_count, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            RandomStream rng(spec.seed, StreamPurpose::SCENARIO_STORE, 0, i);
+            int area = area_mix.sample(rng.uniform());
+            normal_distribution<float> offset(0.0f, spec.spread);
+            float lat = area_lat[area] + offset(rng);
+            float lon = area_lon[area] + offset(rng);
+
+            // A sample store of a drawn category, redrawn with noise
+            const vector<int>& members = fit.stores_by_category[fit.category_mix.sample(rng.uniform())];
+            const Restaurant& sample = fit.stores[members[rng() % members.size()]];
+            lognormal_distribution<float> bags_noise(0.0f, BAGS_NOISE);
+            lognormal_distribution<float> price_noise(0.0f, PRICE_NOISE);
+            normal_distribution<float> rating_noise(0.0f, RATING_NOISE);
+            int bags = max(1, (int)lround(sample.estimated_bags * bags_noise(rng)));
+            float price = max(1.0f, (float)lround(sample.price_per_bag * price_noise(rng)));
+            float rating = round((sample.general_ranking + rating_noise(rng)) * 10.0f) / 10.0f;
+            rating = min(max(rating, 1.0f), 5.0f);
+
+            scenario.stores[i] = Restaurant(i + 1, sample.business_name, "Area " + to_string(area + 1),
+                                            bags, rating, price, lon, lat, sample.business_type);
+        }
+    });
+
+    scenario.customers.resize(customer_count);
+    for_each_chunk(pool, customer_count, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            RandomStream rng(spec.seed, StreamPurpose::SCENARIO_CUSTOMER, 0, i);
+            int area = area_mix.sample(rng.uniform());
+            normal_distribution<float> offset(0.0f, 2.0f * spec.spread);
+            float lat = area_lat[area] + offset(rng);
+            float lon = area_lon[area] + offset(rng);
+
+            int segment = fit.segment_mix.sample(rng.uniform());
+            const vector<int>& members = fit.customers_by_segment[segment];
+            float wtp, rating_w, price_w, novelty_w, leaving_threshold;
+            if (!members.empty()) {
+                // A sample customer of the segment, preferences redrawn with noise
+                const Customer& sample = fit.customers[members[rng() % members.size()]];
+                lognormal_distribution<float> noise(0.0f, PREFERENCE_NOISE);
+                wtp = sample.willingness_to_pay * noise(rng);
+                rating_w = sample.weights.rating_w * noise(rng);
+                price_w = sample.weights.price_w * noise(rng);
+                novelty_w = sample.weights.novelty_w * noise(rng);
+                leaving_threshold = sample.leaving_threshold * noise(rng);
+            } else {
+                const SegmentGenerationParams& params = SEGMENT_RANDOM_CUSTOMER[segment];
+                wtp = draw(params.willingness_to_pay, rng);
+                rating_w = draw(params.rating_w, rng);
+                price_w = draw(params.price_w, rng);
+                novelty_w = draw(params.novelty_w, rng);
+                leaving_threshold = draw(params.leaving_threshold, rng);
+            }
+
+            scenario.customers[i] = Customer(i, lon, lat, "Customer_" + to_string(i),
+                                             segment_name((CustomerSegment)segment),
+                                             wtp, rating_w, price_w, novelty_w, leaving_threshold);
+        }
+    });
+    return scenario;
+}
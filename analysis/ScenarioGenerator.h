@@ -0,0 +1,63 @@
+#ifndef SCENARIO_GENERATOR_H
+#define SCENARIO_GENERATOR_H
+
+#include <vector>
+#include <string>
+#include "Restaurant.h"
+#include "Customer.h"
+#include "SoftmaxSampler.h"
+
+using namespace std;
+
+// Scenario Generator
+// Synthetic cities of any size whose stores and customers look like a
+// sample market (the bundled CSVs). The sample fixes the category mix, the
+// bags/rating/price of each category, the segment ratios and each
+// segment's preferences; new items are sample rows redrawn with noise.
+// Geography is clustered: stores and customers gather around weighted
+// neighbourhood centres spread over the sample's area, scaled up so that
+// store density stays that of the sample.
+// Item i draws only from its own stream, so a population is the same for
+// a seed whatever the thread count.
+
+struct ScenarioSpec {
+    int store_count;
+    int customer_count;
+    int neighbourhoods;      // 0 = one per 100 stores
+    float spread;            // std dev of a store around its centre (degrees)
+    float area_scale;        // side of the city over the sample's; 0 = keep density
+    uint64_t seed;
+
+    // 1000 stores, 10000 customers, auto neighbourhoods and area, 0.01 spread
+    ScenarioSpec();
+};
+
+// Distributions fitted to a sample market
+struct ScenarioFit {
+    vector<Restaurant> stores;
+    vector<string> categories;
+    vector<vector<int>> stores_by_category;   // indexes into stores
+    AliasTable category_mix;
+
+    vector<Customer> customers;
+    vector<vector<int>> customers_by_segment; // BUDGET, REGULAR, PREMIUM
+    AliasTable segment_mix;
+
+    // Sample extent
+    float center_lat, center_lon;
+    float half_lat, half_lon;
+};
+
+// Fit from sample stores (at least one) and customers (may be empty; the
+// segments are then equally likely with the random-customer parameters)
+ScenarioFit fit_scenario(const vector<Restaurant>& stores, const vector<Customer>& customers);
+
+struct Scenario {
+    vector<Restaurant> stores;     // business ids 1..store_count
+    vector<Customer> customers;    // ids 0..customer_count-1
+};
+
+// Generate on threads workers (0 = one per core)
+Scenario generate_scenario(const ScenarioFit& fit, const ScenarioSpec& spec, int threads = 0);
+
+#endif // SCENARIO_GENERATOR_H
@@ -0,0 +1,47 @@
+#include "ScratchArena.h"
+#include <algorithm>
+
+using namespace std;
+
+ScratchArena::ScratchArena(size_t size)
+    : block_size(size), current(0), offset(0), used_in_earlier_blocks(0) {}
+
+void ScratchArena::reset() {
+    current = 0;
+    offset = 0;
+    used_in_earlier_blocks = 0;
+}
+
+size_t ScratchArena::bytes_used() const {
+    return used_in_earlier_blocks + offset;
+}
+
+size_t ScratchArena::bytes_reserved() const {
+    size_t total = 0;
+    for (const auto& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+void* ScratchArena::allocate_bytes(size_t bytes, size_t align) {
+    while (true) {
+        if (current < blocks.size()) {
+            size_t start = (offset + align - 1) & ~(align - 1);
+            if (start + bytes <= blocks[current].size) {
+                offset = start + bytes;
+                return blocks[current].data.get() + start;
+            }
+            // Move on to the next block (kept from an earlier arrival, or new)
+            used_in_earlier_blocks += offset;
+            current++;
+            offset = 0;
+            continue;
+        }
+
+        Block block;
+        block.size = max(block_size, bytes + align);
+        block.data.reset(new char[block.size]);
+        blocks.push_back(std::move(block));
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+using namespace std;
+
+// Scratch Arena
+// Bump allocator for per-arrival temporaries. Allocation is a pointer bump
+// inside the current block; reset() rewinds to the first block without
+// freeing anything, so once the arena has grown to the working set no
+// further heap allocations happen. Only use it for trivially destructible
+// types: nothing allocated here is ever destroyed.
+class ScratchArena {
+public:
+    explicit ScratchArena(size_t block_size = 16 * 1024);
+
+    // Uninitialized storage for count objects of type T
+    template <class T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocate_bytes(count * sizeof(T), alignof(T)));
+    }
+
+    // Forget every allocation (memory is kept for reuse)
+    void reset();
+
+    size_t bytes_used() const;
+    size_t bytes_reserved() const;
+
+private:
+    struct Block {
+        unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    vector<Block> blocks;
+    size_t block_size;
+    size_t current;   // index of the block being filled
+    size_t offset;    // bytes used in that block
+    size_t used_in_earlier_blocks;
+
+    void* allocate_bytes(size_t bytes, size_t align);
+};
+
+#endif // SCRATCH_ARENA_H
@@ -0,0 +1,19 @@
+#include "Segments.h"
+
+using namespace std;
+
+CustomerSegment parse_segment(const string& label) {
+    if (label == "budget") return CustomerSegment::BUDGET;
+    if (label == "regular") return CustomerSegment::REGULAR;
+    if (label == "premium") return CustomerSegment::PREMIUM;
+    return CustomerSegment::OTHER;
+}
+
+const char* segment_name(CustomerSegment segment) {
+    switch (segment) {
+        case CustomerSegment::BUDGET: return "budget";
+        case CustomerSegment::REGULAR: return "regular";
+        case CustomerSegment::PREMIUM: return "premium";
+        default: return "other";
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef SEGMENTS_H
+#define SEGMENTS_H
+
+#include <string>
+
+using namespace std;
+
+// Customer Segments
+// Segment labels from the CSV are parsed once into this enum. OTHER keeps
+// labels the model does not recognise; they match none of the segment
+// specific rules, exactly as an unmatched string compare did.
+enum class CustomerSegment {
+    BUDGET,
+    REGULAR,
+    PREMIUM,
+    OTHER
+};
+
+const int NUM_SEGMENTS = 4;
+
+CustomerSegment parse_segment(const string& label);
+const char* segment_name(CustomerSegment segment);
+
+// Ranking Parameters (Sama and Harmony)
+struct SegmentRankingParams {
+    float rating_weight;         // Sama rating bonus multiplier
+    float inventory_weight;      // Sama inventory urgency multiplier
+    float base_personalization;  // Sama share of personalized slots
+    float satisfaction_bonus;    // Harmony bonus when the segment rule holds
+};
+
+constexpr SegmentRankingParams SEGMENT_RANKING[NUM_SEGMENTS] = {
+    {0.8f, 0.8f, 0.7f, 0.4f},   // BUDGET
+    {1.0f, 0.6f, 0.6f, 0.3f},   // REGULAR
+    {1.5f, 0.5f, 0.5f, 0.5f},   // PREMIUM
+    {1.0f, 0.6f, 0.6f, 0.0f}    // OTHER
+};
+
+// Customer Generation Parameters
+// A drawn value is base + (rng() % range) / scale
+struct SegmentDraw {
+    float base;
+    int range;
+    float scale;
+};
+
+struct SegmentGenerationParams {
+    SegmentDraw willingness_to_pay;
+    SegmentDraw rating_w;
+    SegmentDraw price_w;
+    SegmentDraw novelty_w;
+    SegmentDraw leaving_threshold;
+};
+
+// Fill-ins for columns missing from the customer CSV
+// (unrecognised labels fall back to the premium row)
+constexpr SegmentGenerationParams SEGMENT_CSV_DEFAULTS[NUM_SEGMENTS] = {
+    // BUDGET
+    {{80.0f, 40, 1.0f}, {0.5f, 100, 200.0f}, {1.5f, 100, 200.0f}, {0.2f, 60, 200.0f}, {1.5f, 20, 20.0f}},
+    // REGULAR
+    {{120.0f, 60, 1.0f}, {1.0f, 100, 200.0f}, {0.8f, 80, 200.0f}, {0.4f, 60, 200.0f}, {2.5f, 20, 20.0f}},
+    // PREMIUM
+    {{180.0f, 80, 1.0f}, {1.5f, 100, 200.0f}, {0.3f, 80, 200.0f}, {0.6f, 80, 200.0f}, {3.5f, 20, 20.0f}},
+    // OTHER
+    {{180.0f, 80, 1.0f}, {1.5f, 100, 200.0f}, {0.3f, 80, 200.0f}, {0.6f, 80, 200.0f}, {3.5f, 20, 20.0f}}
+};
+
+// Fully random customers (no CSV loaded)
+constexpr SegmentGenerationParams SEGMENT_RANDOM_CUSTOMER[NUM_SEGMENTS] = {
+    // BUDGET
+    {{80.0f, 40, 1.0f}, {0.5f, 100, 200.0f}, {1.5f, 100, 200.0f}, {0.3f, 100, 200.0f}, {2.0f, 30, 10.0f}},
+    // REGULAR
+    {{120.0f, 60, 1.0f}, {1.0f, 100, 200.0f}, {1.0f, 100, 200.0f}, {0.5f, 100, 200.0f}, {3.0f, 40, 10.0f}},
+    // PREMIUM
+    {{180.0f, 80, 1.0f}, {1.5f, 100, 200.0f}, {0.5f, 100, 200.0f}, {0.8f, 100, 200.0f}, {4.0f, 40, 10.0f}},
+    // OTHER (never drawn)
+    {{180.0f, 80, 1.0f}, {1.5f, 100, 200.0f}, {0.5f, 100, 200.0f}, {0.8f, 100, 200.0f}, {4.0f, 40, 10.0f}}
+};
+
+#endif // SEGMENTS_H
@@ -2,6 +2,8 @@
 #include "CustomerDecisionSystem.h"
 #include "RestaurantManagementSystem.h"
 #include "RankingAlgorithms.h"
+#include "RegionShards.h"
+#include "PhaseTimer.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -11,29 +13,37 @@
 
 using namespace std;
 
+// Stores reveal their inventory and settle once trading closes
+static const Timestamp DAY_CLOSE(22, 0);
+
 SimulationEngine::SimulationEngine(int n_display, const string& customer_csv, 
-                                   RankingAlgorithm algorithm)
+                                   RankingAlgorithm algorithm, uint64_t seed)
     : n_displayed(n_display),
-      // Use fixed seed if CSV is empty (for reproducibility)
-      arrival_generator(customer_csv, customer_csv.empty() ? 12345 : time(nullptr)),
+      arrival_generator(customer_csv, seed),
       ranking_algorithm(algorithm),
+      choice_temperature(DEFAULT_CHOICE_TEMPERATURE),
+      seed(seed),
+      shard_threads(1),
       next_customer_id(0),
       output_stream(&cout),
       use_pre_generated_data(false) {}
 
 void SimulationEngine::initialize(const vector<Restaurant>& restaurants) {
-    market_state.restaurants = restaurants;
+    market_state.set_restaurants(restaurants);
 
-    mt19937 rng(time(nullptr));
+    // Day 0 inventory streams; each store draws its own variance
     uniform_real_distribution<float> variance(0.8f, 1.2f);
-
-    for (auto& restaurant : market_state.restaurants) {
+    for (int slot = 0; slot < market_state.get_restaurant_count(); slot++) {
+        Restaurant& restaurant = market_state.restaurant_at(slot);
+        RandomStream rng(seed, StreamPurpose::INVENTORY, 0, slot);
         int actual = (int)(restaurant.estimated_bags * variance(rng));
         restaurant.set_actual_inventory(max(0, actual));
+        market_state.refresh_store(slot);
     }
 }
 
 void SimulationEngine::run_day_simulation(int num_customers, bool use_customer_pool, int day_index) {
+    PHASE_RECORDER(phase_times);
     string algo_name = "BASELINE";
     if (ranking_algorithm == RankingAlgorithm::SAMA) algo_name = "SAMA";
     else if (ranking_algorithm == RankingAlgorithm::ANDREW) algo_name = "ANDREW";
@@ -41,74 +51,84 @@ void SimulationEngine::run_day_simulation(int num_customers, bool use_customer_p
     else if (ranking_algorithm == RankingAlgorithm::ZIAD) algo_name = "ZIAD";
     else if (ranking_algorithm == RankingAlgorithm::HARMONY) algo_name = "HARMONY";
     
-    *output_stream << "\n=== Starting Day Simulation (" << algo_name << " Algorithm) ===" << endl;
-    *output_stream << "Number of customers: " << num_customers << endl;
-    *output_stream << "Number of stores: " << market_state.restaurants.size() << endl;
-
-    *output_stream << "\nInitial Store Inventory:" << endl;
-    for (const auto& r : market_state.restaurants) {
-        *output_stream << r.business_name << ": Estimated=" << r.estimated_bags
-            << ", Actual=" << r.actual_bags
-            << ", Price=$" << r.price_per_bag
-            << ", Rating=" << fixed << setprecision(2) << r.get_rating() << endl;
+    {
+        PHASE_SCOPE(SimPhase::LOG_OUTPUT);
+        *output_stream << "\n=== Starting Day Simulation (" << algo_name << " Algorithm) ===" << endl;
+        *output_stream << "Number of customers: " << num_customers << endl;
+        *output_stream << "Number of stores: " << market_state.restaurants.size() << endl;
+
+        *output_stream << "\nInitial Store Inventory:" << endl;
+        for (const auto& r : market_state.restaurants) {
+            *output_stream << r.business_name << ": Estimated=" << r.estimated_bags
+                << ", Actual=" << r.actual_bags
+                << ", Price=$" << r.price_per_bag
+                << ", Rating=" << fixed << setprecision(2) << r.get_rating() << endl;
+        }
     }
 
-    // Use pre-generated arrival times if available
-    vector<Timestamp> arrival_times;
+    // Use pre-generated arrival times if available; otherwise the day's
+    // arrivals are streamed as it runs
+    DayArrivals day;
+    day.count = num_customers;
+    day.served = 0;
+    day.day_index = day_index;
+    day.use_customer_pool = use_customer_pool;
+    day.pool_index = 0;
+    day.times = nullptr;
+    day.customers = nullptr;
     if (use_pre_generated_data && day_index >= 0 && day_index < (int)pre_generated_arrival_times.size()) {
-        arrival_times = pre_generated_arrival_times[day_index];
+        day.times = &pre_generated_arrival_times[day_index];
     } else {
-        arrival_times = arrival_generator.generate_arrival_times(num_customers);
+        PHASE_SCOPE(SimPhase::ARRIVAL_GENERATION);
+        day.stream = arrival_generator.stream_arrival_times(num_customers, max(day_index, 0));
     }
 
-    int successful_reservations = 0;
-    int active_customer_index = 0;
-    
-    for (int i = 0; i < num_customers; i++) {
-        Customer customer;
-        
-        // Always use pre-generated customers if available (for fair comparison)
-        if (use_pre_generated_data && active_customer_index < (int)customer_pool.size()) {
-            customer = customer_pool[active_customer_index];
-            active_customer_index++;
-        } else if (use_customer_pool && active_customer_index < (int)customer_pool.size()) {
-            customer = customer_pool[active_customer_index];
-            active_customer_index++;
-        } else {
-            // Fallback: generate new customer
-            customer = arrival_generator.generate_customer(next_customer_id++, market_state.restaurants);
-            if (use_customer_pool) {
-                customer_pool.push_back(customer);
-            }
-        }
-        
-        market_state.current_time = arrival_times[i];
-
-        metrics_collector.log_customer_arrival(customer.id, arrival_times[i]);
-
-        vector<int> displayed = get_displayed_stores(customer, market_state, n_displayed, ranking_algorithm);
-        metrics_collector.log_stores_displayed(displayed);
-
-        market_state.customers.insert(make_pair(customer.id, customer));
-
-        int selected = CustomerDecisionSystem::process_customer_arrival(
-            market_state.customers[customer.id], market_state, n_displayed, ranking_algorithm);
+    // Trading closes at DAY_CLOSE, or with the last arrival if later. A
+    // streamed day can run until its profile closes.
+    EventTime close = to_event_time(DAY_CLOSE);
+    if (day.times && num_customers > 0) {
+        close = max(close, to_event_time((*day.times)[num_customers - 1]));
+    } else if (!day.times) {
+        const IntensityProfile& profile = arrival_generator.get_arrival_profile().for_day(max(day_index, 0));
+        close = max(close, to_event_time(Timestamp::from_seconds(profile.closing_minute() * 60)));
+    }
+    events.reset();
 
-        if (selected == -1) {
-            metrics_collector.log_customer_left(customer.id);
+    // Region shards serve the whole day's arrivals in one batch, so the day
+    // is drawn up front; if it does not split, the event queue replays it
+    int successful_reservations = -1;
+    vector<Customer> arrivals;
+    vector<Timestamp> arrival_times;
+    if (shard_threads > 1 && supports_region_shards(ranking_algorithm)) {
+        Customer customer;
+        Timestamp time;
+        while (next_arrival(day, customer, time)) {
+            arrivals.push_back(customer);
+            arrival_times.push_back(time);
         }
-        else {
-            successful_reservations++;
+        successful_reservations = run_arrivals_sharded(arrivals, arrival_times, day_index);
+        day.served = 0;
+        day.count = (int)arrivals.size();
+        day.times = &arrival_times;
+        day.customers = &arrivals;
+    }
+    if (successful_reservations < 0) {
+        // Only the next arrival is ever queued
+        successful_reservations = 0;
+        if (next_arrival(day, day.upcoming, day.upcoming_time)) {
+            events.schedule(to_event_time(day.upcoming_time), EventType::ARRIVAL, 0);
         }
     }
+    events.schedule(close, EventType::DAY_END);
+    run_events(day, successful_reservations);
 
-    *output_stream << "\nTotal Reservations Made: " << successful_reservations << endl;
-    *output_stream << "Processing end of day..." << endl;
-    RestaurantManagementSystem::process_end_of_day(market_state);
+    {
+        PHASE_SCOPE(SimPhase::METRICS);
+        metrics_collector.log_end_of_day(market_state);
+        metrics_collector.calculate_fairness_metrics(market_state);
+    }
 
-    metrics_collector.log_end_of_day(market_state);
-    metrics_collector.calculate_fairness_metrics(market_state);
-    
+    PHASE_SCOPE(SimPhase::LOG_OUTPUT);
     *output_stream << "\n=== RATING CHANGES (Dynamic Ratings) ===" << endl;
     for (const auto& r : market_state.restaurants) {
         float rating_change = r.get_rating() - r.rating_at_day_start;
@@ -120,18 +140,237 @@ void SimulationEngine::run_day_simulation(int num_customers, bool use_customer_p
     }
 }
 
+// Next customer and arrival time of the day, in order; false when done
+bool SimulationEngine::next_arrival(DayArrivals& day, Customer& customer, Timestamp& time) {
+    if (day.served >= day.count) return false;
+    PHASE_SCOPE(SimPhase::ARRIVAL_GENERATION);
+
+    if (day.customers) {
+        customer = (*day.customers)[day.served];
+    } else if (use_pre_generated_data && day.pool_index < (int)customer_pool.size()) {
+        // Always use pre-generated customers if available (for fair comparison)
+        customer = customer_pool[day.pool_index];
+        day.pool_index++;
+    } else if (day.use_customer_pool && day.pool_index < (int)customer_pool.size()) {
+        customer = customer_pool[day.pool_index];
+        day.pool_index++;
+    } else {
+        // Fallback: generate new customer
+        customer = arrival_generator.generate_customer(next_customer_id++, market_state.restaurants);
+        if (day.use_customer_pool) {
+            customer_pool.push_back(customer);
+        }
+    }
+
+    time = day.times ? (*day.times)[day.served] : day.stream.next();
+    day.served++;
+    return true;
+}
+
+bool SimulationEngine::serve_arrival(const Customer& customer, Timestamp time, int day_index,
+                                     MarketState& market, MetricsCollector& metrics,
+                                     ArrivalContext& context) const {
+    market.current_time = time;
+
+    // Rank once; the decision step and the metrics reuse the context
+    {
+        PHASE_SCOPE(SimPhase::RANKING);
+        get_displayed_stores(customer, market, n_displayed, ranking_algorithm, context);
+    }
+    {
+        PHASE_SCOPE(SimPhase::METRICS);
+        metrics.log_customer_arrival(customer.id, time);
+        metrics.log_stores_displayed(context.slate_ids);
+    }
+
+    int selected;
+    {
+        PHASE_SCOPE(SimPhase::CUSTOMER_DECISION);
+        market.customers.insert(make_pair(customer.id, customer));
+
+        RandomStream choice_rng(seed, StreamPurpose::STORE_CHOICE, max(day_index, 0), customer.id);
+        selected = CustomerDecisionSystem::process_customer_arrival(
+            market.customers[customer.id], market, context, choice_rng, choice_temperature);
+    }
+
+    if (selected == -1) {
+        PHASE_SCOPE(SimPhase::METRICS);
+        metrics.log_customer_left(customer.id);
+        return false;
+    }
+    return true;
+}
+
+// Dispatch events until the day is settled. Closing reveals every store's
+// inventory; each reveal queues the pickups and cancellations it decides,
+// in the order the stores and their customers are served.
+void SimulationEngine::run_events(DayArrivals& day, int successful_reservations) {
+    vector<pair<int, int>> outcomes;
+    Event event;
+    while (events.pop(event)) {
+        switch (event.type) {
+        case EventType::ARRIVAL:
+            if (serve_arrival(day.upcoming, day.upcoming_time, day.day_index,
+                              market_state, metrics_collector, arrival_context)) {
+                successful_reservations++;
+            }
+            if (next_arrival(day, day.upcoming, day.upcoming_time)) {
+                events.schedule(to_event_time(day.upcoming_time), EventType::ARRIVAL, day.served - 1);
+            }
+            break;
+
+        case EventType::DAY_END: {
+            {
+                PHASE_SCOPE(SimPhase::LOG_OUTPUT);
+                *output_stream << "\nTotal Reservations Made: " << successful_reservations << endl;
+                *output_stream << "Processing end of day..." << endl;
+            }
+            PHASE_SCOPE(SimPhase::SETTLEMENT);
+            RestaurantManagementSystem::pending_by_slot(market_state, pending_reservations);
+            for (int slot = 0; slot < market_state.get_restaurant_count(); slot++) {
+                events.schedule(event.time, EventType::INVENTORY_REVEAL, slot);
+            }
+            break;
+        }
+
+        case EventType::INVENTORY_REVEAL: {
+            PHASE_SCOPE(SimPhase::SETTLEMENT);
+            outcomes.clear();
+            RestaurantManagementSystem::settle_store(market_state, event.subject,
+                                                     pending_reservations[event.subject], outcomes);
+            for (const auto& outcome : outcomes) {
+                events.schedule(event.time,
+                                outcome.second > 0 ? EventType::PICKUP : EventType::CANCELLATION,
+                                outcome.first, outcome.second);
+            }
+            break;
+        }
+
+        case EventType::PICKUP:
+        case EventType::CANCELLATION: {
+            PHASE_SCOPE(SimPhase::SETTLEMENT);
+            Reservation& res = market_state.reservations[event.subject];
+            Customer* customer = market_state.get_customer(res.customer_id);
+            if (event.type == EventType::PICKUP) {
+                RestaurantManagementSystem::handle_confirmation(res, *customer, market_state, event.value);
+            } else {
+                RestaurantManagementSystem::handle_cancellation(res, *customer, market_state);
+            }
+            break;
+        }
+        }
+    }
+}
+
+// Each shard replays its customers, in arrival order, on a private copy of
+// the market. Shards share no store, so every store and customer ends the
+// day as it would sequentially; the copies are then folded back and the
+// reservations renumbered in global arrival order. Returns -1, with nothing
+// served, when the day does not split into more than one shard.
+int SimulationEngine::run_arrivals_sharded(const vector<Customer>& arrivals,
+                                           const vector<Timestamp>& arrival_times, int day_index) {
+    vector<int> store_shard;
+    vector<vector<int>> shards = shard_arrivals(arrivals, market_state, shard_threads, store_shard);
+    if (shards.size() <= 1) {
+        return -1;
+    }
+
+    struct ShardResult {
+        MarketState market;
+        MetricsCollector metrics;
+        vector<pair<int, Reservation>> reservations;   // (arrival index, reservation)
+        int successful_reservations;
+        PhaseTimes phase_times;
+    };
+    vector<ShardResult> results(shards.size());
+
+    if (!shard_pool) {
+        shard_pool.reset(new ThreadPool(shard_threads));
+    }
+    for (size_t s = 0; s < shards.size(); s++) {
+        shard_pool->submit([this, s, &shards, &results, &arrivals, &arrival_times, day_index]() {
+            ShardResult& result = results[s];
+            PHASE_RECORDER(result.phase_times);
+            MarketState& market = result.market;
+            market.copy_stores_from(market_state);
+            for (int i : shards[s]) {
+                auto it = market_state.customers.find(arrivals[i].id);
+                if (it != market_state.customers.end()) {
+                    market.customers.insert(*it);
+                }
+            }
+
+            ArrivalContext context;
+            result.successful_reservations = 0;
+            for (int i : shards[s]) {
+                size_t made = market.reservations.size();
+                if (serve_arrival(arrivals[i], arrival_times[i], day_index,
+                                  market, result.metrics, context)) {
+                    result.successful_reservations++;
+                }
+                if (market.reservations.size() > made) {
+                    result.reservations.push_back(make_pair(i, market.reservations.back()));
+                }
+            }
+        });
+    }
+    shard_pool->wait();
+
+    PHASE_SCOPE(SimPhase::METRICS);
+    for (const auto& result : results) {
+        phase_times.add(result.phase_times);
+    }
+
+    // Stores and impressions come from the shard that owns them
+    for (int slot = 0; slot < market_state.get_restaurant_count(); slot++) {
+        if (store_shard[slot] < 0) continue;
+        const MarketState& market = results[store_shard[slot]].market;
+        market_state.restaurant_at(slot) = market.restaurant_at(slot);
+        market_state.refresh_store(slot);
+        market_state.add_impressions(slot, market.get_impressions(slot));
+    }
+
+    int successful_reservations = 0;
+    vector<pair<int, Reservation>> reservations;
+    for (size_t s = 0; s < shards.size(); s++) {
+        ShardResult& result = results[s];
+        for (int i : shards[s]) {
+            market_state.customers[arrivals[i].id] = result.market.customers[arrivals[i].id];
+        }
+        metrics_collector.merge_arrivals(result.metrics.metrics);
+        reservations.insert(reservations.end(), result.reservations.begin(), result.reservations.end());
+        successful_reservations += result.successful_reservations;
+    }
+
+    sort(reservations.begin(), reservations.end(),
+        [](const pair<int, Reservation>& a, const pair<int, Reservation>& b) { return a.first < b.first; });
+    for (auto& entry : reservations) {
+        entry.second.reservation_id = market_state.next_reservation_id++;
+        market_state.reservations.push_back(entry.second);
+    }
+
+    if (!arrivals.empty()) {
+        market_state.current_time = arrival_times[arrivals.size() - 1];
+    }
+    return successful_reservations;
+}
+
 void SimulationEngine::run_multi_day_simulation(int num_days, int num_customers_per_day) {
+    PHASE_RECORDER(phase_times);
     string algo_name = "BASELINE";
     if (ranking_algorithm == RankingAlgorithm::SAMA) algo_name = "SAMA";
     else if (ranking_algorithm == RankingAlgorithm::ANDREW) algo_name = "ANDREW";
     else if (ranking_algorithm == RankingAlgorithm::AMER) algo_name = "AMER";
     else if (ranking_algorithm == RankingAlgorithm::ZIAD) algo_name = "ZIAD";
     
-    *output_stream << "\n" << string(70, '=') << endl;
-    *output_stream << "=== Starting " << num_days << "-Day Simulation (" << algo_name << " Algorithm) ===" << endl;
-    *output_stream << "Number of customers per day: " << num_customers_per_day << endl;
-    *output_stream << "Number of stores: " << market_state.restaurants.size() << endl;
-    *output_stream << string(70, '=') << endl;
+    {
+        PHASE_SCOPE(SimPhase::LOG_OUTPUT);
+        *output_stream << "\n" << string(70, '=') << endl;
+        *output_stream << "=== Starting " << num_days << "-Day Simulation (" << algo_name << " Algorithm) ===" << endl;
+        *output_stream << "Number of customers per day: " << num_customers_per_day << endl;
+        *output_stream << "Number of stores: " << market_state.restaurants.size() << endl;
+        *output_stream << string(70, '=') << endl;
+    }
 
     // Store initial ratings
     for (auto& r : market_state.restaurants) {
@@ -139,7 +378,7 @@ void SimulationEngine::run_multi_day_simulation(int num_days, int num_customers_
     }
     
     // Reset impression counts
-    market_state.impression_counts.clear();
+    market_state.reset_impressions();
 
     SimulationMetrics aggregated_metrics;
     
@@ -157,6 +396,7 @@ void SimulationEngine::run_multi_day_simulation(int num_days, int num_customers_
         next_customer_id = pre_generated_customers.size();
     } else if (customer_pool.empty()) {
         // Pre-generate a pool
+        PHASE_SCOPE(SimPhase::ARRIVAL_GENERATION);
         for (int i = 0; i < num_customers_per_day * 2; i++) {
             Customer customer = arrival_generator.generate_customer(next_customer_id++, market_state.restaurants);
             customer_pool.push_back(customer);
@@ -164,43 +404,51 @@ void SimulationEngine::run_multi_day_simulation(int num_days, int num_customers_
     }
     
     for (int day = 1; day <= num_days; day++) {
-        *output_stream << "\n" << string(70, '-') << endl;
-        *output_stream << "DAY " << day << " of " << num_days << endl;
-        *output_stream << string(70, '-') << endl;
+        {
+            PHASE_SCOPE(SimPhase::LOG_OUTPUT);
+            *output_stream << "\n" << string(70, '-') << endl;
+            *output_stream << "DAY " << day << " of " << num_days << endl;
+            *output_stream << string(70, '-') << endl;
+        }
 
         // Reset daily state
         market_state.reservations.clear();
         market_state.current_time = Timestamp(8, 0);
         market_state.next_reservation_id = 1;
 
-        // Filter out churned customers
-        vector<Customer> active_customers;
-        for (const auto& customer : customer_pool) {
-            if (!customer.churned) {
-                active_customers.push_back(customer);
+        // Carry over active customers and replenish the pool
+        {
+            PHASE_SCOPE(SimPhase::ARRIVAL_GENERATION);
+            // Filter out churned customers
+            vector<Customer> active_customers;
+            for (const auto& customer : customer_pool) {
+                if (!customer.churned) {
+                    active_customers.push_back(customer);
+                }
             }
-        }
         
-        // Replenish customer pool if needed
-        while ((int)active_customers.size() < num_customers_per_day) {
-            Customer new_customer;
-            if (use_pre_generated_data && next_customer_id < (int)pre_generated_customers.size()) {
-                new_customer = pre_generated_customers[next_customer_id];
-                new_customer.id = next_customer_id;
-                new_customer.churned = false;
-                new_customer.history = CustomerHistory();
-                new_customer.loyalty = 0.8f;
-            } else {
-                new_customer = arrival_generator.generate_customer(next_customer_id, market_state.restaurants);
+            // Replenish customer pool if needed
+            while ((int)active_customers.size() < num_customers_per_day) {
+                Customer new_customer;
+                if (use_pre_generated_data && next_customer_id < (int)pre_generated_customers.size()) {
+                    new_customer = pre_generated_customers[next_customer_id];
+                    new_customer.id = next_customer_id;
+                    new_customer.churned = false;
+                    new_customer.history = CustomerHistory();
+                    new_customer.loyalty = 0.8f;
+                } else {
+                    new_customer = arrival_generator.generate_customer(next_customer_id, market_state.restaurants);
+                }
+                active_customers.push_back(new_customer);
+                next_customer_id++;
             }
-            active_customers.push_back(new_customer);
-            next_customer_id++;
-        }
         
-        customer_pool = active_customers;
+            customer_pool = active_customers;
+        }
         
         // Reset restaurant daily state
-        for (auto& restaurant : market_state.restaurants) {
+        for (int slot = 0; slot < market_state.get_restaurant_count(); slot++) {
+            Restaurant& restaurant = market_state.restaurant_at(slot);
             restaurant.rating_at_day_start = restaurant.general_ranking;
             restaurant.daily_orders_confirmed = 0;
             restaurant.daily_orders_cancelled = 0;
@@ -208,10 +456,11 @@ void SimulationEngine::run_multi_day_simulation(int num_days, int num_customers_
             restaurant.has_inventory = true;
             
             // Randomize daily inventory
-            mt19937 rng(time(nullptr) + day);
+            RandomStream rng(seed, StreamPurpose::INVENTORY, day, slot);
             uniform_real_distribution<float> variance(0.8f, 1.2f);
             int actual = (int)(restaurant.estimated_bags * variance(rng));
             restaurant.set_actual_inventory(max(0, actual));
+            market_state.refresh_store(slot);
         }
         
         metrics_collector.metrics = SimulationMetrics();
@@ -234,58 +483,66 @@ void SimulationEngine::run_multi_day_simulation(int num_days, int num_customers_
 
         // Aggregate metrics
         const auto& day_metrics = metrics_collector.metrics;
-        aggregated_metrics.total_bags_sold += day_metrics.total_bags_sold;
-        aggregated_metrics.total_bags_cancelled += day_metrics.total_bags_cancelled;
-        aggregated_metrics.total_bags_unsold += day_metrics.total_bags_unsold;
-        aggregated_metrics.total_revenue_generated += day_metrics.total_revenue_generated;
-        aggregated_metrics.total_revenue_lost += day_metrics.total_revenue_lost;
-        aggregated_metrics.customers_who_left += day_metrics.customers_who_left;
-        aggregated_metrics.total_customer_arrivals += day_metrics.total_customer_arrivals;
-
-        // Aggregate per-store metrics
-        for (const auto& pair : day_metrics.bags_sold_per_store) {
-            aggregated_metrics.bags_sold_per_store[pair.first] += pair.second;
-        }
-        for (const auto& pair : day_metrics.bags_cancelled_per_store) {
-            aggregated_metrics.bags_cancelled_per_store[pair.first] += pair.second;
-        }
-        for (const auto& pair : day_metrics.waste_per_store) {
-            aggregated_metrics.waste_per_store[pair.first] += pair.second;
-        }
-        for (const auto& pair : day_metrics.revenue_per_store) {
-            aggregated_metrics.revenue_per_store[pair.first] += pair.second;
-        }
-        for (const auto& pair : day_metrics.times_displayed_per_store) {
-            aggregated_metrics.times_displayed_per_store[pair.first] += pair.second;
+        {
+            PHASE_SCOPE(SimPhase::METRICS);
+            aggregated_metrics.total_bags_sold += day_metrics.total_bags_sold;
+            aggregated_metrics.total_bags_cancelled += day_metrics.total_bags_cancelled;
+            aggregated_metrics.total_bags_unsold += day_metrics.total_bags_unsold;
+            aggregated_metrics.total_revenue_generated += day_metrics.total_revenue_generated;
+            aggregated_metrics.total_revenue_lost += day_metrics.total_revenue_lost;
+            aggregated_metrics.customers_who_left += day_metrics.customers_who_left;
+            aggregated_metrics.total_customer_arrivals += day_metrics.total_customer_arrivals;
+
+            // Aggregate per-store metrics
+            for (const auto& pair : day_metrics.bags_sold_per_store) {
+                aggregated_metrics.bags_sold_per_store[pair.first] += pair.second;
+            }
+            for (const auto& pair : day_metrics.bags_cancelled_per_store) {
+                aggregated_metrics.bags_cancelled_per_store[pair.first] += pair.second;
+            }
+            for (const auto& pair : day_metrics.waste_per_store) {
+                aggregated_metrics.waste_per_store[pair.first] += pair.second;
+            }
+            for (const auto& pair : day_metrics.revenue_per_store) {
+                aggregated_metrics.revenue_per_store[pair.first] += pair.second;
+            }
+            for (const auto& pair : day_metrics.times_displayed_per_store) {
+                aggregated_metrics.times_displayed_per_store[pair.first] += pair.second;
+            }
         }
 
+        PHASE_SCOPE(SimPhase::LOG_OUTPUT);
         *output_stream << "\nDay " << day << " Summary:" << endl;
         *output_stream << "  Bags Sold: " << day_metrics.total_bags_sold << endl;
         *output_stream << "  Waste: " << day_metrics.total_bags_unsold << endl;
         *output_stream << "  Revenue: $" << fixed << setprecision(2) << day_metrics.total_revenue_generated << endl;
     }
 
-    // Calculate final fairness metric (Gini)
-    vector<int> exposures;
-    for (const auto& restaurant : market_state.restaurants) {
-        exposures.push_back(aggregated_metrics.times_displayed_per_store[restaurant.business_id]);
-    }
-    if (!exposures.empty()) {
-        sort(exposures.begin(), exposures.end());
-        float sum = 0.0f;
-        float weighted_sum = 0.0f;
-        for (size_t i = 0; i < exposures.size(); i++) {
-            sum += exposures[i];
-            weighted_sum += exposures[i] * (i + 1);
+    {
+        PHASE_SCOPE(SimPhase::METRICS);
+        // Calculate final fairness metric (Gini)
+        vector<int> exposures;
+        for (const auto& restaurant : market_state.restaurants) {
+            exposures.push_back(aggregated_metrics.times_displayed_per_store[restaurant.business_id]);
         }
-        if (sum > 0) {
-            int n = exposures.size();
-            aggregated_metrics.gini_coefficient_exposure = (2.0f * weighted_sum) / (n * sum) - (n + 1.0f) / n;
+        if (!exposures.empty()) {
+            sort(exposures.begin(), exposures.end());
+            float sum = 0.0f;
+            float weighted_sum = 0.0f;
+            for (size_t i = 0; i < exposures.size(); i++) {
+                sum += exposures[i];
+                weighted_sum += exposures[i] * (i + 1);
+            }
+            if (sum > 0) {
+                int n = exposures.size();
+                aggregated_metrics.gini_coefficient_exposure = (2.0f * weighted_sum) / (n * sum) - (n + 1.0f) / n;
+            }
         }
-    }
 
-    metrics_collector.metrics = aggregated_metrics;
+        metrics_collector.metrics = aggregated_metrics;
+    }
 
+    PHASE_SCOPE(SimPhase::LOG_OUTPUT);
     *output_stream << "\n" << string(70, '=') << endl;
     *output_stream << "=== " << num_days << "-DAY SIMULATION COMPLETE ===" << endl;
     *output_stream << string(70, '=') << endl;
@@ -295,14 +552,28 @@ const SimulationMetrics& SimulationEngine::get_metrics() const {
     return metrics_collector.metrics;
 }
 
+const MarketState& SimulationEngine::get_market_state() const {
+    return market_state;
+}
+
+const PhaseTimes& SimulationEngine::get_phase_times() const {
+    return phase_times;
+}
+
 void SimulationEngine::export_results(const string& filename) {
+    ofstream out(filename);
+    export_results(out);
+}
+
+void SimulationEngine::export_results(ostream& out) {
+    PHASE_RECORDER(phase_times);
+    PHASE_SCOPE(SimPhase::LOG_OUTPUT);
     string algo_name = "BASELINE";
     if (ranking_algorithm == RankingAlgorithm::SAMA) algo_name = "SAMA";
     else if (ranking_algorithm == RankingAlgorithm::ANDREW) algo_name = "ANDREW";
     else if (ranking_algorithm == RankingAlgorithm::AMER) algo_name = "AMER";
     else if (ranking_algorithm == RankingAlgorithm::ZIAD) algo_name = "ZIAD";
     
-    ofstream out(filename);
     out << "Algorithm," << algo_name << "\n";
     out << "Restaurant,Estimated,Actual,Reserved,Sold,Cancelled,Waste,Revenue,Exposures\n";
 
@@ -325,11 +596,11 @@ void SimulationEngine::export_results(const string& filename) {
             << metrics_collector.metrics.revenue_per_store[restaurant.business_id] << ","
             << metrics_collector.metrics.times_displayed_per_store[restaurant.business_id] << "\n";
     }
-
-    out.close();
 }
 
 void SimulationEngine::log_detailed_metrics(const SimulationMetrics* comparison_metrics) {
+    PHASE_RECORDER(phase_times);
+    PHASE_SCOPE(SimPhase::LOG_OUTPUT);
     ofstream log("simulation_log.txt", ios::app);
     string algo_name = "BASELINE";
     if (ranking_algorithm == RankingAlgorithm::SAMA) algo_name = "SAMA";
@@ -413,3 +684,22 @@ void SimulationEngine::set_arrival_times(const vector<vector<Timestamp>>& times)
     use_pre_generated_data = true;
 }
 
+void SimulationEngine::set_choice_temperature(float temperature) {
+    choice_temperature = temperature;
+}
+
+void SimulationEngine::set_shard_threads(int threads) {
+    shard_threads = max(threads, 1);
+    if (shard_pool && shard_pool->size() != shard_threads) {
+        shard_pool.reset();
+    }
+}
+
+void SimulationEngine::set_arrival_profile(const WeeklyArrivalProfile& profile) {
+    arrival_generator.set_arrival_profile(profile);
+}
+
+void SimulationEngine::set_travel_distance(float distance) {
+    market_state.set_travel_distance(distance);
+}
+
@@ -3,11 +3,15 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 #include "MarketState.h"
 #include "Metrics.h"
 #include "ArrivalGenerator.h"
 #include "RankingAlgorithms.h"
 #include "Restaurant.h"
+#include "EventScheduler.h"
+#include "PhaseTimer.h"
+#include "ThreadPool.h"
 
 using namespace std;
 
@@ -19,6 +23,14 @@ private:
     ArrivalGenerator arrival_generator;
     int n_displayed;
     RankingAlgorithm ranking_algorithm;
+    ArrivalContext arrival_context;   // reused for every arrival
+    float choice_temperature;         // softmax temperature for store choice
+    uint64_t seed;                    // root of every random stream
+    int shard_threads;                // region shards per day (1 = sequential)
+    unique_ptr<ThreadPool> shard_pool;   // shard_threads workers, made on the first sharded day
+    EventScheduler events;            // day's event queue, reused across days
+    vector<vector<int>> pending_reservations;   // reservation indexes per slot, at close
+    PhaseTimes phase_times;           // filled only when built with SIM_PHASE_TIMING
     vector<Customer> customer_pool;
     int next_customer_id;
     ostream* output_stream;
@@ -26,10 +38,42 @@ private:
     vector<vector<Timestamp>> pre_generated_arrival_times;
     bool use_pre_generated_data;
 
+    // Where the day in progress takes its arrivals from
+    struct DayArrivals {
+        int count;                          // arrivals in the day
+        int served;                         // arrivals handed out so far
+        int day_index;
+        bool use_customer_pool;
+        int pool_index;                     // next pool customer
+        const vector<Timestamp>* times;     // fixed schedule, or null to stream
+        const vector<Customer>* customers;  // fixed customers, or null to pick
+        ArrivalStream stream;
+        Customer upcoming;                  // the one arrival waiting in the queue
+        Timestamp upcoming_time;
+    };
+
+    bool next_arrival(DayArrivals& day, Customer& customer, Timestamp& time);
+
+    // One arrival against market: rank, log and let the customer choose.
+    // Returns true when a reservation was made.
+    bool serve_arrival(const Customer& customer, Timestamp time, int day_index,
+                       MarketState& market, MetricsCollector& metrics,
+                       ArrivalContext& context) const;
+
+    // Serve a day's arrivals on region shards; returns the number of
+    // reservations, or -1 when the day runs through the event queue instead
+    int run_arrivals_sharded(const vector<Customer>& arrivals, const vector<Timestamp>& arrival_times,
+                             int day_index);
+
+    // Process queued events until the day is settled
+    void run_events(DayArrivals& day, int successful_reservations);
+
 public:
     // Constructor
+    // Runs with the same seed produce identical results
     SimulationEngine(int n_display, const string& customer_csv, 
-                     RankingAlgorithm algorithm = RankingAlgorithm::BASELINE);
+                     RankingAlgorithm algorithm = RankingAlgorithm::BASELINE,
+                     uint64_t seed = DEFAULT_SIMULATION_SEED);
 
     // Initialize
     void initialize(const vector<Restaurant>& restaurants);
@@ -43,8 +87,15 @@ public:
     // Get metrics
     const SimulationMetrics& get_metrics() const;
 
-    // Export results
+    // Market as the last day left it (stores, customers, reservations)
+    const MarketState& get_market_state() const;
+
+    // Time spent per phase so far (all zero unless built with SIM_PHASE_TIMING)
+    const PhaseTimes& get_phase_times() const;
+
+    // Export results (per-store CSV)
     void export_results(const string& filename);
+    void export_results(ostream& out);
 
     // Log detailed metrics
     void log_detailed_metrics(const SimulationMetrics* comparison_metrics = nullptr);
@@ -57,6 +108,20 @@ public:
     
     // Set arrival times
     void set_arrival_times(const vector<vector<Timestamp>>& times);
+
+    // Set how random customers' store choice is (default 2.0)
+    void set_choice_temperature(float temperature);
+
+    // Set the time-of-day arrival intensity for days without set arrival times
+    void set_arrival_profile(const WeeklyArrivalProfile& profile);
+
+    // Set the customers' pickup radius (default MAX_TRAVEL_DISTANCE)
+    void set_travel_distance(float distance);
+
+    // Split each day's arrivals into up to this many region shards run on
+    // their own threads (default 1). Results match the sequential engine;
+    // algorithms that rank the whole market always run sequentially.
+    void set_shard_threads(int threads);
 };
 
 #endif // SIMULATION_ENGINE_H
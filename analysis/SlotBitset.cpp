@@ -0,0 +1,43 @@
+#include "SlotBitset.h"
+#include <algorithm>
+
+using namespace std;
+
+SlotBitset::SlotBitset() : num_slots(0), num_set(0) {}
+
+void SlotBitset::reset(int n) {
+    num_slots = n;
+    num_set = 0;
+    words.assign((n + 63) / 64, 0);
+}
+
+void SlotBitset::clear() {
+    fill(words.begin(), words.end(), 0);
+    num_set = 0;
+}
+
+void SlotBitset::assign(int slot, bool value) {
+    uint64_t mask = (uint64_t)1 << (slot & 63);
+    uint64_t& word = words[slot >> 6];
+    bool current = (word & mask) != 0;
+    if (current == value) return;
+    if (value) {
+        word |= mask;
+        num_set++;
+    } else {
+        word &= ~mask;
+        num_set--;
+    }
+}
+
+int SlotBitset::count() const {
+    return num_set;
+}
+
+int SlotBitset::size() const {
+    return num_slots;
+}
+
+bool SlotBitset::empty() const {
+    return num_set == 0;
+}
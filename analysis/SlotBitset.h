@@ -0,0 +1,98 @@
+#ifndef SLOT_BITSET_H
+#define SLOT_BITSET_H
+
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Slot Bitset
+// One bit per store slot packed into 64-bit words, with a running count.
+// Iteration visits set slots in ascending order without allocating, so
+// a range-for over the bitset replaces building a vector of slots.
+class SlotBitset {
+public:
+    class const_iterator {
+    public:
+        const_iterator(const SlotBitset* bits, int word, uint64_t remaining);
+
+        int operator*() const;
+        const_iterator& operator++();
+        bool operator!=(const const_iterator& other) const;
+
+    private:
+        const SlotBitset* bits;
+        int word;
+        uint64_t remaining;   // unvisited bits of the current word
+
+        void skip_empty_words();
+    };
+
+    SlotBitset();
+
+    // Resize to hold slots [0, n) and clear every bit
+    void reset(int n);
+
+    // Clear every bit, keeping the size
+    void clear();
+
+    // Set or clear one slot
+    void assign(int slot, bool value);
+    bool test(int slot) const;
+
+    // Number of set slots / capacity in slots
+    int count() const;
+    int size() const;
+    bool empty() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    vector<uint64_t> words;
+    int num_slots;
+    int num_set;
+};
+
+// Hot-path members are defined inline so iteration compiles to a tight loop
+
+inline bool SlotBitset::test(int slot) const {
+    return (words[slot >> 6] >> (slot & 63)) & 1;
+}
+
+inline SlotBitset::const_iterator SlotBitset::begin() const {
+    return const_iterator(this, 0, words.empty() ? 0 : words[0]);
+}
+
+inline SlotBitset::const_iterator SlotBitset::end() const {
+    return const_iterator(this, (int)words.size(), 0);
+}
+
+inline SlotBitset::const_iterator::const_iterator(const SlotBitset* b, int w, uint64_t r)
+    : bits(b), word(w), remaining(r) {
+    skip_empty_words();
+}
+
+inline void SlotBitset::const_iterator::skip_empty_words() {
+    int num_words = (int)bits->words.size();
+    while (remaining == 0 && word < num_words) {
+        word++;
+        remaining = word < num_words ? bits->words[word] : 0;
+    }
+}
+
+inline int SlotBitset::const_iterator::operator*() const {
+    return word * 64 + __builtin_ctzll(remaining);
+}
+
+inline SlotBitset::const_iterator& SlotBitset::const_iterator::operator++() {
+    remaining &= remaining - 1;   // drop the lowest set bit
+    skip_empty_words();
+    return *this;
+}
+
+inline bool SlotBitset::const_iterator::operator!=(const const_iterator& other) const {
+    return word != other.word || remaining != other.remaining;
+}
+
+#endif // SLOT_BITSET_H
@@ -0,0 +1,286 @@
+#include "SoftmaxSampler.h"
+#include "StoreScoring.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SOFTMAX_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Range reduction: x = n * ln2 + r, with ln2 split so n * EXP_LN2_HI is exact
+static const float EXP_MIN_X = -87.0f;
+static const float EXP_MAX_X = 88.0f;
+static const float EXP_LOG2E = 1.44269504088896341f;
+static const float EXP_LN2_HI = 0.693359375f;
+static const float EXP_LN2_LO = -2.12194440e-4f;
+
+// Minimax polynomial for (exp(r) - 1 - r) / r^2 on [-ln2/2, ln2/2]
+static const float EXP_P0 = 1.9875691500e-4f;
+static const float EXP_P1 = 1.3981999507e-3f;
+static const float EXP_P2 = 8.3334519073e-3f;
+static const float EXP_P3 = 4.1665795894e-2f;
+static const float EXP_P4 = 1.6666665459e-1f;
+static const float EXP_P5 = 5.0000001201e-1f;
+
+float fast_exp(float x) {
+    x = min(max(x, EXP_MIN_X), EXP_MAX_X);
+    float n = floor(x * EXP_LOG2E + 0.5f);
+    float r = x - n * EXP_LN2_HI;
+    r = r - n * EXP_LN2_LO;
+
+    float p = EXP_P0;
+    p = p * r + EXP_P1;
+    p = p * r + EXP_P2;
+    p = p * r + EXP_P3;
+    p = p * r + EXP_P4;
+    p = p * r + EXP_P5;
+    p = p * (r * r) + r + 1.0f;
+
+    // Scale by 2^n through the exponent bits
+    int bits = ((int)n + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// out[i] = fast_exp((scores[i] - shift) * inv_temperature)
+static void exp_shifted_scalar(const float* scores, int count, float shift, float inv_temperature, float* out) {
+    for (int i = 0; i < count; i++) {
+        out[i] = fast_exp((scores[i] - shift) * inv_temperature);
+    }
+}
+
+#ifdef SOFTMAX_X86
+// Same operation order as fast_exp, no FMA
+__attribute__((target("avx2")))
+static void exp_shifted_avx2(const float* scores, int count, float shift, float inv_temperature, float* out) {
+    const __m256 shift_v = _mm256_set1_ps(shift);
+    const __m256 inv_t = _mm256_set1_ps(inv_temperature);
+    const __m256 lo = _mm256_set1_ps(EXP_MIN_X);
+    const __m256 hi = _mm256_set1_ps(EXP_MAX_X);
+    const __m256 log2e = _mm256_set1_ps(EXP_LOG2E);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 ln2_hi = _mm256_set1_ps(EXP_LN2_HI);
+    const __m256 ln2_lo = _mm256_set1_ps(EXP_LN2_LO);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i bias = _mm256_set1_epi32(127);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&scores[i]), shift_v), inv_t);
+        x = _mm256_min_ps(_mm256_max_ps(x, lo), hi);
+        __m256 n = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, log2e), half));
+        __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(n, ln2_hi));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(n, ln2_lo));
+
+        __m256 p = _mm256_set1_ps(EXP_P0);
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_P1));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_P2));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_P3));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_P4));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_P5));
+        p = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p, _mm256_mul_ps(r, r)), r), one);
+
+        __m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n), bias), 23);
+        _mm256_storeu_ps(&out[i], _mm256_mul_ps(p, _mm256_castsi256_ps(bits)));
+    }
+    exp_shifted_scalar(scores + i, count - i, shift, inv_temperature, out + i);
+}
+
+__attribute__((target("sse2")))
+static void exp_shifted_sse2(const float* scores, int count, float shift, float inv_temperature, float* out) {
+    const __m128 shift_v = _mm_set1_ps(shift);
+    const __m128 inv_t = _mm_set1_ps(inv_temperature);
+    const __m128 lo = _mm_set1_ps(EXP_MIN_X);
+    const __m128 hi = _mm_set1_ps(EXP_MAX_X);
+    const __m128 log2e = _mm_set1_ps(EXP_LOG2E);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 ln2_hi = _mm_set1_ps(EXP_LN2_HI);
+    const __m128 ln2_lo = _mm_set1_ps(EXP_LN2_LO);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i bias = _mm_set1_epi32(127);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&scores[i]), shift_v), inv_t);
+        x = _mm_min_ps(_mm_max_ps(x, lo), hi);
+
+        // floor without SSE4.1: truncate, then step down where that rounded up
+        __m128 t = _mm_add_ps(_mm_mul_ps(x, log2e), half);
+        __m128 n = _mm_cvtepi32_ps(_mm_cvttps_epi32(t));
+        n = _mm_sub_ps(n, _mm_and_ps(_mm_cmpgt_ps(n, t), one));
+
+        __m128 r = _mm_sub_ps(x, _mm_mul_ps(n, ln2_hi));
+        r = _mm_sub_ps(r, _mm_mul_ps(n, ln2_lo));
+
+        __m128 p = _mm_set1_ps(EXP_P0);
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P1));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P2));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P3));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P4));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P5));
+        p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, _mm_mul_ps(r, r)), r), one);
+
+        __m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), bias), 23);
+        _mm_storeu_ps(&out[i], _mm_mul_ps(p, _mm_castsi128_ps(bits)));
+    }
+    exp_shifted_scalar(scores + i, count - i, shift, inv_temperature, out + i);
+}
+#endif
+
+// Follows the store scoring kernel selection (set_scoring_kernel)
+static void exp_shifted(const float* scores, int count, float shift, float inv_temperature, float* out) {
+#ifdef SOFTMAX_X86
+    ScoringKernel kernel = get_scoring_kernel();
+    if (kernel == ScoringKernel::AVX2) {
+        exp_shifted_avx2(scores, count, shift, inv_temperature, out);
+        return;
+    }
+    if (kernel == ScoringKernel::SSE2) {
+        exp_shifted_sse2(scores, count, shift, inv_temperature, out);
+        return;
+    }
+#endif
+    exp_shifted_scalar(scores, count, shift, inv_temperature, out);
+}
+
+// Unnormalized softmax weights; returns their sum. Shifting by the maximum
+// leaves the distribution unchanged and keeps every exponent <= 0.
+static float softmax_weights(const float* scores, int count, float temperature, float* out) {
+    float max_score = *max_element(scores, scores + count);
+    exp_shifted(scores, count, max_score, 1.0f / temperature, out);
+
+    // Summed in index order so the result does not depend on the kernel
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++) {
+        sum += out[i];
+    }
+    return sum;
+}
+
+void softmax(const float* scores, int count, float temperature, float* out) {
+    if (count <= 0) return;
+    float inv_sum = 1.0f / softmax_weights(scores, count, temperature, out);
+    for (int i = 0; i < count; i++) {
+        out[i] *= inv_sum;
+    }
+}
+
+AliasTable::AliasTable() : count(0) {}
+
+void AliasTable::build(const float* weights, int n) {
+    count = n;
+    probability.resize(n);
+    alias.resize(n);
+    small_work.clear();
+    large_work.clear();
+    if (n <= 0) return;
+
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        sum += weights[i];
+    }
+
+    // Scale so the average column holds exactly 1
+    float scale = sum > 0.0f ? n / sum : 0.0f;
+    for (int i = 0; i < n; i++) {
+        probability[i] = sum > 0.0f ? weights[i] * scale : 1.0f;
+        alias[i] = i;
+        if (probability[i] < 1.0f) {
+            small_work.push_back(i);
+        } else {
+            large_work.push_back(i);
+        }
+    }
+
+    // Fill each short column with mass from a tall one
+    while (!small_work.empty() && !large_work.empty()) {
+        int s = small_work.back();
+        small_work.pop_back();
+        int l = large_work.back();
+        alias[s] = l;
+        probability[l] = (probability[l] + probability[s]) - 1.0f;
+        if (probability[l] < 1.0f) {
+            large_work.pop_back();
+            small_work.push_back(l);
+        }
+    }
+
+    // Leftovers are 1 up to rounding
+    for (int i : small_work) probability[i] = 1.0f;
+    for (int i : large_work) probability[i] = 1.0f;
+}
+
+int AliasTable::sample(float u) const {
+    float scaled = u * count;
+    int column = min((int)scaled, count - 1);
+    return (scaled - column) < probability[column] ? column : alias[column];
+}
+
+int AliasTable::size() const {
+    return count;
+}
+
+// Per-thread buffers for the samplers
+struct SoftmaxScratch {
+    vector<float> shifted;
+    vector<float> weights;
+    AliasTable table;
+};
+
+static SoftmaxScratch& softmax_scratch() {
+    static thread_local SoftmaxScratch scratch;
+    return scratch;
+}
+
+int sample_softmax(const float* scores, int count, float temperature, float u) {
+    if (count <= 0) return -1;
+    if (count == 1) return 0;
+
+    SoftmaxScratch& scratch = softmax_scratch();
+    scratch.weights.resize(count);
+    softmax_weights(scores, count, temperature, scratch.weights.data());
+    scratch.table.build(scratch.weights.data(), count);
+    return scratch.table.sample(u);
+}
+
+// Slates are short, so one row alone barely fills a vector. The rows are
+// shifted by their own maximum and packed end to end, then exponentiated in
+// a single pass. (s - max) - 0 == s - max exactly, so every weight matches
+// the one sample_softmax computes for that row.
+void sample_softmax_batch(const float* scores, int stride, const int* counts, int rows,
+                          float temperature, const float* uniforms, int* choices) {
+    SoftmaxScratch& scratch = softmax_scratch();
+    scratch.shifted.clear();
+    for (int r = 0; r < rows; r++) {
+        const float* row = scores + (size_t)r * stride;
+        if (counts[r] <= 0) continue;
+        float max_score = *max_element(row, row + counts[r]);
+        for (int i = 0; i < counts[r]; i++) {
+            scratch.shifted.push_back(row[i] - max_score);
+        }
+    }
+
+    int total = (int)scratch.shifted.size();
+    scratch.weights.resize(total);
+    exp_shifted(scratch.shifted.data(), total, 0.0f, 1.0f / temperature, scratch.weights.data());
+
+    int offset = 0;
+    for (int r = 0; r < rows; r++) {
+        if (counts[r] <= 0) {
+            choices[r] = -1;
+            continue;
+        }
+        if (counts[r] == 1) {
+            choices[r] = 0;
+        } else {
+            scratch.table.build(&scratch.weights[offset], counts[r]);
+            choices[r] = scratch.table.sample(uniforms[r]);
+        }
+        offset += counts[r];
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SOFTMAX_SAMPLER_H
+#define SOFTMAX_SAMPLER_H
+
+#include <vector>
+
+using namespace std;
+
+// Softmax Sampler
+// Turns option scores into a softmax distribution and draws from it. The
+// exponentials use fast_exp, evaluated 8 or 4 lanes at a time with the
+// kernel picked for store scoring; every kernel gives bit-identical values.
+
+// exp(x) via range reduction and a polynomial. Relative error stays below
+// 1e-7 (about one ulp) for x in [-87, 88]; inputs outside are clamped.
+float fast_exp(float x);
+
+// out[i] = softmax(scores / temperature)[i] (higher temperature = flatter)
+void softmax(const float* scores, int count, float temperature, float* out);
+
+// Alias Table
+// Walker/Vose alias method: O(n) to build, then every draw costs one
+// uniform, one multiply and one comparison regardless of n.
+class AliasTable {
+public:
+    AliasTable();
+
+    // Build from non-negative weights (they need not sum to 1)
+    void build(const float* weights, int count);
+
+    // Draw an index in [0, size()) from u uniform in [0, 1)
+    int sample(float u) const;
+
+    int size() const;
+
+private:
+    int count;
+    vector<float> probability;
+    vector<int> alias;
+    vector<int> small_work;   // build worklists, kept for reuse
+    vector<int> large_work;
+};
+
+// Draw an index in [0, count) from softmax(scores / temperature).
+// Deterministic given u; uses per-thread buffers (no allocation once warm).
+int sample_softmax(const float* scores, int count, float temperature, float u);
+
+// Batch variant: one draw per row of a score tile. Row r holds counts[r]
+// scores at scores + r * stride and uses uniforms[r]; choices[r] is the
+// same index sample_softmax would return for that row, or -1 if it is empty.
+void sample_softmax_batch(const float* scores, int stride, const int* counts, int rows,
+                          float temperature, const float* uniforms, int* choices);
+
+#endif // SOFTMAX_SAMPLER_H
@@ -0,0 +1,103 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+
+using namespace std;
+
+// Never let the grid grow far beyond the number of stores
+static const int CELLS_PER_STORE = 4;
+
+SpatialIndex::SpatialIndex()
+    : min_lat(0.0f), min_lon(0.0f), cell_size(1.0f), rows(0), cols(0) {}
+
+float SpatialIndex::distance(float lat1, float lon1, float lat2, float lon2) {
+    float dlat = lat2 - lat1;
+    float dlon = lon2 - lon1;
+    return sqrt(dlat * dlat + dlon * dlon);
+}
+
+void SpatialIndex::build(const StoreTable& stores, float cell) {
+    int n = stores.size();
+    cell_start.clear();
+    entry_slot.clear();
+    entry_lat.clear();
+    entry_lon.clear();
+    rows = cols = 0;
+    if (n == 0) return;
+
+    float max_lat = stores.latitude[0], max_lon = stores.longitude[0];
+    min_lat = max_lat;
+    min_lon = max_lon;
+    for (int slot = 1; slot < n; slot++) {
+        min_lat = min(min_lat, stores.latitude[slot]);
+        max_lat = max(max_lat, stores.latitude[slot]);
+        min_lon = min(min_lon, stores.longitude[slot]);
+        max_lon = max(max_lon, stores.longitude[slot]);
+    }
+
+    // Widen cells for sparse, spread-out catalogs to bound memory
+    cell_size = cell > 0.0f ? cell : 1.0f;
+    double max_cells = (double)CELLS_PER_STORE * n + 16;
+    while (((double)(max_lat - min_lat) / cell_size + 1) * ((double)(max_lon - min_lon) / cell_size + 1) > max_cells) {
+        cell_size *= 2.0f;
+    }
+    rows = (int)((max_lat - min_lat) / cell_size) + 1;
+    cols = (int)((max_lon - min_lon) / cell_size) + 1;
+
+    // Counting sort of slots into cells (slot order is kept within a cell)
+    vector<int> cell_of(n);
+    cell_start.assign(rows * cols + 1, 0);
+    for (int slot = 0; slot < n; slot++) {
+        cell_of[slot] = cell_row(stores.latitude[slot]) * cols + cell_col(stores.longitude[slot]);
+        cell_start[cell_of[slot] + 1]++;
+    }
+    for (int c = 0; c < rows * cols; c++) {
+        cell_start[c + 1] += cell_start[c];
+    }
+
+    entry_slot.resize(n);
+    entry_lat.resize(n);
+    entry_lon.resize(n);
+    vector<int> fill(cell_start.begin(), cell_start.end() - 1);
+    for (int slot = 0; slot < n; slot++) {
+        int e = fill[cell_of[slot]]++;
+        entry_slot[e] = slot;
+        entry_lat[e] = stores.latitude[slot];
+        entry_lon[e] = stores.longitude[slot];
+    }
+}
+
+int SpatialIndex::cell_row(float lat) const {
+    int row = (int)floor((lat - min_lat) / cell_size);
+    return min(max(row, 0), rows - 1);
+}
+
+int SpatialIndex::cell_col(float lon) const {
+    int col = (int)floor((lon - min_lon) / cell_size);
+    return min(max(col, 0), cols - 1);
+}
+
+// Covering range slack so float rounding at cell borders never drops a store
+float SpatialIndex::padded(float radius) const {
+    return radius * 1.001f + 1e-4f;
+}
+
+void SpatialIndex::query_radius(float lat, float lon, float radius, vector<int>& out) const {
+    if (rows == 0) return;
+
+    float reach = padded(radius);
+    if (lat + reach < min_lat || lon + reach < min_lon) return;
+    if (lat - reach > min_lat + rows * cell_size || lon - reach > min_lon + cols * cell_size) return;
+
+    int row_begin = cell_row(lat - reach), row_end = cell_row(lat + reach);
+    int col_begin = cell_col(lon - reach), col_end = cell_col(lon + reach);
+
+    for (int row = row_begin; row <= row_end; row++) {
+        for (int cell = row * cols + col_begin; cell <= row * cols + col_end; cell++) {
+            for (int e = cell_start[cell]; e < cell_start[cell + 1]; e++) {
+                if (distance(lat, lon, entry_lat[e], entry_lon[e]) <= radius) {
+                    out.push_back(entry_slot[e]);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <vector>
+#include <cmath>
+#include "StoreTable.h"
+
+using namespace std;
+
+// Spatial Index
+// Uniform grid over store coordinates with the cell size set to the travel
+// radius, so a radius query touches at most a 3x3 block of cells. Distances
+// use the same float math as the scoring code, so "within radius" here
+// agrees exactly with the travel-distance checks elsewhere.
+class SpatialIndex {
+public:
+    SpatialIndex();
+
+    // Rebuild from the store table (call whenever the catalog changes)
+    void build(const StoreTable& stores, float cell_size);
+
+    // Append every slot within radius of (lat, lon) to out
+    void query_radius(float lat, float lon, float radius, vector<int>& out) const;
+
+    // Closest accepted slot within max_radius, -1 if none.
+    // Ties go to the lower slot. Accept is any bool(int slot) callable.
+    template <class Accept>
+    int nearest(float lat, float lon, float max_radius, Accept accept) const;
+
+    // Distance as computed by the scoring code
+    static float distance(float lat1, float lon1, float lat2, float lon2);
+
+private:
+    float min_lat;
+    float min_lon;
+    float cell_size;
+    int rows;    // latitude cells
+    int cols;    // longitude cells
+
+    // CSR layout: cell c owns entries [cell_start[c], cell_start[c + 1])
+    vector<int> cell_start;
+    vector<int> entry_slot;
+    vector<float> entry_lat;
+    vector<float> entry_lon;
+
+    int cell_row(float lat) const;
+    int cell_col(float lon) const;
+    float padded(float radius) const;
+};
+
+template <class Accept>
+int SpatialIndex::nearest(float lat, float lon, float max_radius, Accept accept) const {
+    if (rows == 0) return -1;
+
+    int best_slot = -1;
+    float best_distance = 0.0f;
+
+    // Search rings of cells outward from the customer's cell; stop once a
+    // ring cannot contain anything closer than the best match so far
+    int center_row = cell_row(lat);
+    int center_col = cell_col(lon);
+    int max_ring = (int)ceil(padded(max_radius) / cell_size) + 1;
+
+    for (int ring = 0; ring <= max_ring; ring++) {
+        if (best_slot != -1 && (ring - 1) * cell_size > padded(best_distance)) break;
+
+        for (int row = center_row - ring; row <= center_row + ring; row++) {
+            if (row < 0 || row >= rows) continue;
+            bool edge_row = (row == center_row - ring || row == center_row + ring);
+            int step = edge_row ? 1 : 2 * ring;
+            for (int col = center_col - ring; col <= center_col + ring; col += (step > 0 ? step : 1)) {
+                if (col < 0 || col >= cols) continue;
+                int cell = row * cols + col;
+                for (int e = cell_start[cell]; e < cell_start[cell + 1]; e++) {
+                    float d = distance(lat, lon, entry_lat[e], entry_lon[e]);
+                    if (d > max_radius) continue;
+                    int slot = entry_slot[e];
+                    if (best_slot != -1 && (d > best_distance || (d == best_distance && slot > best_slot))) continue;
+                    if (!accept(slot)) continue;
+                    best_slot = slot;
+                    best_distance = d;
+                }
+            }
+        }
+    }
+    return best_slot;
+}
+
+#endif // SPATIAL_INDEX_H
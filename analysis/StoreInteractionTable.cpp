@@ -0,0 +1,111 @@
+#include "StoreInteractionTable.h"
+#include <algorithm>
+
+using namespace std;
+
+StoreInteraction::StoreInteraction()
+    : reservations(0), successes(0), cancellations(0) {}
+
+// Every recorded event bumps a counter, so an existing record is never all zero
+static bool is_unused(const StoreInteraction& entry) {
+    return entry.reservations == 0 && entry.successes == 0 && entry.cancellations == 0;
+}
+
+StoreInteractionTable::StoreInteractionTable() : dense_count(0), dense(false) {}
+
+const StoreInteraction* StoreInteractionTable::find(int slot) const {
+    if (dense) {
+        if (slot < 0 || slot >= (int)dense_entries.size()) return nullptr;
+        const StoreInteraction& entry = dense_entries[slot];
+        return is_unused(entry) ? nullptr : &entry;
+    }
+    auto it = lower_bound(small_slots.begin(), small_slots.end(), slot);
+    if (it == small_slots.end() || *it != slot) return nullptr;
+    return &small_entries[it - small_slots.begin()];
+}
+
+StoreInteraction& StoreInteractionTable::operator[](int slot) {
+    // A new slot past the flat array must not thin it out too far
+    if (dense && slot >= (int)dense_entries.size() && !dense_enough(dense_count + 1, slot)) {
+        switch_to_small();
+    }
+
+    if (!dense) {
+        auto it = lower_bound(small_slots.begin(), small_slots.end(), slot);
+        int pos = (int)(it - small_slots.begin());
+        if (it != small_slots.end() && *it == slot) {
+            return small_entries[pos];
+        }
+        int count = (int)small_slots.size() + 1;
+        int max_slot = max(slot, small_slots.empty() ? slot : small_slots.back());
+        if (count <= DENSE_THRESHOLD || !dense_enough(count, max_slot)) {
+            small_slots.insert(it, slot);
+            small_entries.insert(small_entries.begin() + pos, StoreInteraction());
+            return small_entries[pos];
+        }
+        switch_to_dense();
+    }
+
+    if (slot >= (int)dense_entries.size()) {
+        dense_entries.resize(slot + 1);
+    }
+    StoreInteraction& entry = dense_entries[slot];
+    if (is_unused(entry)) {
+        dense_count++;
+    }
+    return entry;
+}
+
+// Dense mode has to count; this is not used on hot paths
+int StoreInteractionTable::size() const {
+    if (!dense) return (int)small_slots.size();
+    int count = 0;
+    for (const auto& entry : dense_entries) {
+        if (!is_unused(entry)) count++;
+    }
+    return count;
+}
+
+bool StoreInteractionTable::is_dense() const {
+    return dense;
+}
+
+void StoreInteractionTable::clear() {
+    small_slots.clear();
+    small_entries.clear();
+    dense_entries.clear();
+    dense_count = 0;
+    dense = false;
+}
+
+bool StoreInteractionTable::dense_enough(int count, int max_slot) {
+    return (long long)count * DENSE_FILL >= (long long)max_slot + 1;
+}
+
+void StoreInteractionTable::switch_to_dense() {
+    int max_slot = small_slots.empty() ? 0 : small_slots.back();
+    dense_entries.assign(max_slot + 1, StoreInteraction());
+    for (size_t i = 0; i < small_slots.size(); i++) {
+        dense_entries[small_slots[i]] = small_entries[i];
+    }
+    dense_count = (int)small_slots.size();
+    dense = true;
+
+    vector<int>().swap(small_slots);
+    vector<StoreInteraction>().swap(small_entries);
+}
+
+void StoreInteractionTable::switch_to_small() {
+    small_slots.clear();
+    small_entries.clear();
+    for (int slot = 0; slot < (int)dense_entries.size(); slot++) {
+        if (!is_unused(dense_entries[slot])) {
+            small_slots.push_back(slot);
+            small_entries.push_back(dense_entries[slot]);
+        }
+    }
+    dense = false;
+
+    vector<StoreInteraction>().swap(dense_entries);
+    dense_count = 0;
+}
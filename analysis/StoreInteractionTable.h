@@ -0,0 +1,61 @@
+#ifndef STORE_INTERACTION_TABLE_H
+#define STORE_INTERACTION_TABLE_H
+
+#include <vector>
+
+using namespace std;
+
+// Per-store counters in a customer's history
+struct StoreInteraction {
+    int reservations;
+    int successes;
+    int cancellations;
+
+    StoreInteraction();
+};
+
+// Store Interaction Table
+// A customer's StoreInteraction records keyed by store slot. Most customers
+// touch only a few stores, so entries start out in a small sorted vector
+// (binary search, no per-entry allocation). Once a customer has touched
+// more than DENSE_THRESHOLD stores, and those fill at least 1/DENSE_FILL of
+// the slots up to the highest one, the table switches to a flat array
+// indexed by slot, making every lookup a single array access. A customer
+// spread thinly over a large catalog stays sorted, and a dense table that
+// would drop below that fill goes back to sorted.
+class StoreInteractionTable {
+public:
+    static const int DENSE_THRESHOLD = 16;
+    static const int DENSE_FILL = 4;
+
+    StoreInteractionTable();
+
+    // Record for a slot, or nullptr if the customer never touched it
+    const StoreInteraction* find(int slot) const;
+
+    // Record for a slot, created on first use
+    StoreInteraction& operator[](int slot);
+
+    // Number of stores with a record
+    int size() const;
+    bool is_dense() const;
+
+    void clear();
+
+private:
+    // Small mode: parallel arrays sorted by slot
+    vector<int> small_slots;
+    vector<StoreInteraction> small_entries;
+
+    // Dense mode: entries indexed by slot; an all-zero entry means "none"
+    vector<StoreInteraction> dense_entries;
+    int dense_count;   // entries handed out in dense mode
+    bool dense;
+
+    // Whether count records up to max_slot fill the flat array enough
+    static bool dense_enough(int count, int max_slot);
+    void switch_to_dense();
+    void switch_to_small();
+};
+
+#endif // STORE_INTERACTION_TABLE_H
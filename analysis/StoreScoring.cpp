@@ -0,0 +1,290 @@
+#include "StoreScoring.h"
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STORE_SCORING_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+CustomerScoringParams::CustomerScoringParams()
+    : latitude(0.0f), longitude(0.0f), willingness_to_pay(0.0f), rating_w(0.0f), price_w(0.0f) {}
+
+CustomerScoringParams::CustomerScoringParams(const Customer& customer, const StoreTable& stores) {
+    load(customer, stores);
+}
+
+void CustomerScoringParams::load(const Customer& customer, const StoreTable& stores) {
+    latitude = customer.latitude;
+    longitude = customer.longitude;
+    willingness_to_pay = customer.willingness_to_pay;
+    rating_w = customer.weights.rating_w;
+    price_w = customer.weights.price_w;
+
+    // Novelty only depends on the store's category, so resolve it once per
+    // category instead of once per store
+    novelty_by_category.resize(stores.num_categories);
+    for (int c = 0; c < stores.num_categories; c++) {
+        int reserved = customer.history.times_reserved(c);
+        if (reserved == 0) {
+            novelty_by_category[c] = customer.weights.novelty_w * 1.0f;
+        } else {
+            novelty_by_category[c] = customer.weights.novelty_w * (1.0f / (1.0f + reserved));
+        }
+    }
+}
+
+// Scalar reference, operation-for-operation identical to Customer::score_store
+static void score_range_scalar(const CustomerScoringParams& p, const StoreTable& stores,
+                               int begin, int end, float* out) {
+    for (int slot = begin; slot < end; slot++) {
+        float dlat = stores.latitude[slot] - p.latitude;
+        float dlon = stores.longitude[slot] - p.longitude;
+        float distance = sqrt(dlat * dlat + dlon * dlon);
+        if (distance > stores.max_travel_distance) {
+            out[slot - begin] = -100.0f;
+            continue;
+        }
+        float rating_score = p.rating_w * stores.rating[slot];
+        float price_score = p.price_w * (p.willingness_to_pay - stores.price_per_bag[slot]) / p.willingness_to_pay;
+        float novelty_score = p.novelty_by_category[stores.category[slot]];
+        float normalized_distance = distance / stores.max_travel_distance;
+        float distance_score = (1.0f - normalized_distance) * 1.5f;
+        out[slot - begin] = rating_score + price_score + novelty_score + distance_score;
+    }
+}
+
+#ifdef STORE_SCORING_X86
+// No FMA: separate multiply/add keeps results bit-identical to the scalar path
+__attribute__((target("avx2")))
+static void score_range_avx2(const CustomerScoringParams& p, const StoreTable& stores,
+                             int begin, int end, float* out) {
+    const __m256 cust_lat = _mm256_set1_ps(p.latitude);
+    const __m256 cust_lon = _mm256_set1_ps(p.longitude);
+    const __m256 wtp = _mm256_set1_ps(p.willingness_to_pay);
+    const __m256 rating_w = _mm256_set1_ps(p.rating_w);
+    const __m256 price_w = _mm256_set1_ps(p.price_w);
+    const __m256 max_dist = _mm256_set1_ps(stores.max_travel_distance);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 one_half = _mm256_set1_ps(1.5f);
+    const __m256 too_far = _mm256_set1_ps(-100.0f);
+    const float* novelty = p.novelty_by_category.data();
+
+    int slot = begin;
+    for (; slot + 8 <= end; slot += 8) {
+        __m256 dlat = _mm256_sub_ps(_mm256_loadu_ps(&stores.latitude[slot]), cust_lat);
+        __m256 dlon = _mm256_sub_ps(_mm256_loadu_ps(&stores.longitude[slot]), cust_lon);
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dlat, dlat), _mm256_mul_ps(dlon, dlon)));
+
+        __m256 rating_score = _mm256_mul_ps(rating_w, _mm256_loadu_ps(&stores.rating[slot]));
+        __m256 price_score = _mm256_div_ps(
+            _mm256_mul_ps(price_w, _mm256_sub_ps(wtp, _mm256_loadu_ps(&stores.price_per_bag[slot]))), wtp);
+        __m256i category = _mm256_loadu_si256((const __m256i*)&stores.category[slot]);
+        __m256 novelty_score = _mm256_i32gather_ps(novelty, category, 4);
+        __m256 distance_score = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_div_ps(distance, max_dist)), one_half);
+
+        __m256 total = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(rating_score, price_score), novelty_score),
+                                     distance_score);
+        __m256 far = _mm256_cmp_ps(distance, max_dist, _CMP_GT_OQ);
+        _mm256_storeu_ps(&out[slot - begin], _mm256_blendv_ps(total, too_far, far));
+    }
+    score_range_scalar(p, stores, slot, end, out + (slot - begin));
+}
+
+__attribute__((target("sse2")))
+static void score_range_sse2(const CustomerScoringParams& p, const StoreTable& stores,
+                             int begin, int end, float* out) {
+    const __m128 cust_lat = _mm_set1_ps(p.latitude);
+    const __m128 cust_lon = _mm_set1_ps(p.longitude);
+    const __m128 wtp = _mm_set1_ps(p.willingness_to_pay);
+    const __m128 rating_w = _mm_set1_ps(p.rating_w);
+    const __m128 price_w = _mm_set1_ps(p.price_w);
+    const __m128 max_dist = _mm_set1_ps(stores.max_travel_distance);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 one_half = _mm_set1_ps(1.5f);
+    const __m128 too_far = _mm_set1_ps(-100.0f);
+    const float* novelty = p.novelty_by_category.data();
+    const int* category = stores.category.data();
+
+    int slot = begin;
+    for (; slot + 4 <= end; slot += 4) {
+        __m128 dlat = _mm_sub_ps(_mm_loadu_ps(&stores.latitude[slot]), cust_lat);
+        __m128 dlon = _mm_sub_ps(_mm_loadu_ps(&stores.longitude[slot]), cust_lon);
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dlat, dlat), _mm_mul_ps(dlon, dlon)));
+
+        __m128 rating_score = _mm_mul_ps(rating_w, _mm_loadu_ps(&stores.rating[slot]));
+        __m128 price_score = _mm_div_ps(
+            _mm_mul_ps(price_w, _mm_sub_ps(wtp, _mm_loadu_ps(&stores.price_per_bag[slot]))), wtp);
+        __m128 novelty_score = _mm_setr_ps(novelty[category[slot]], novelty[category[slot + 1]],
+                                           novelty[category[slot + 2]], novelty[category[slot + 3]]);
+        __m128 distance_score = _mm_mul_ps(_mm_sub_ps(one, _mm_div_ps(distance, max_dist)), one_half);
+
+        __m128 total = _mm_add_ps(_mm_add_ps(_mm_add_ps(rating_score, price_score), novelty_score),
+                                  distance_score);
+        __m128 far = _mm_cmpgt_ps(distance, max_dist);
+        _mm_storeu_ps(&out[slot - begin], _mm_or_ps(_mm_and_ps(far, too_far), _mm_andnot_ps(far, total)));
+    }
+    score_range_scalar(p, stores, slot, end, out + (slot - begin));
+}
+#endif
+
+// Slot lists run the same arithmetic on gathered columns, so each score is
+// bit-identical to the one score_range_scalar gives for that slot
+static void score_slots_scalar(const CustomerScoringParams& p, const StoreTable& stores,
+                               const int* slots, int count, float* out) {
+    for (int i = 0; i < count; i++) {
+        score_range_scalar(p, stores, slots[i], slots[i] + 1, out + i);
+    }
+}
+
+#ifdef STORE_SCORING_X86
+__attribute__((target("avx2")))
+static void score_slots_avx2(const CustomerScoringParams& p, const StoreTable& stores,
+                             const int* slots, int count, float* out) {
+    const __m256 cust_lat = _mm256_set1_ps(p.latitude);
+    const __m256 cust_lon = _mm256_set1_ps(p.longitude);
+    const __m256 wtp = _mm256_set1_ps(p.willingness_to_pay);
+    const __m256 rating_w = _mm256_set1_ps(p.rating_w);
+    const __m256 price_w = _mm256_set1_ps(p.price_w);
+    const __m256 max_dist = _mm256_set1_ps(stores.max_travel_distance);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 one_half = _mm256_set1_ps(1.5f);
+    const __m256 too_far = _mm256_set1_ps(-100.0f);
+    const float* novelty = p.novelty_by_category.data();
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i slot = _mm256_loadu_si256((const __m256i*)&slots[i]);
+        __m256 dlat = _mm256_sub_ps(_mm256_i32gather_ps(stores.latitude.data(), slot, 4), cust_lat);
+        __m256 dlon = _mm256_sub_ps(_mm256_i32gather_ps(stores.longitude.data(), slot, 4), cust_lon);
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dlat, dlat), _mm256_mul_ps(dlon, dlon)));
+
+        __m256 rating_score = _mm256_mul_ps(rating_w, _mm256_i32gather_ps(stores.rating.data(), slot, 4));
+        __m256 price_score = _mm256_div_ps(
+            _mm256_mul_ps(price_w, _mm256_sub_ps(wtp, _mm256_i32gather_ps(stores.price_per_bag.data(), slot, 4))),
+            wtp);
+        __m256i category = _mm256_i32gather_epi32(stores.category.data(), slot, 4);
+        __m256 novelty_score = _mm256_i32gather_ps(novelty, category, 4);
+        __m256 distance_score = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_div_ps(distance, max_dist)), one_half);
+
+        __m256 total = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(rating_score, price_score), novelty_score),
+                                     distance_score);
+        __m256 far = _mm256_cmp_ps(distance, max_dist, _CMP_GT_OQ);
+        _mm256_storeu_ps(&out[i], _mm256_blendv_ps(total, too_far, far));
+    }
+    score_slots_scalar(p, stores, slots + i, count - i, out + i);
+}
+
+__attribute__((target("sse2")))
+static void score_slots_sse2(const CustomerScoringParams& p, const StoreTable& stores,
+                             const int* slots, int count, float* out) {
+    const __m128 cust_lat = _mm_set1_ps(p.latitude);
+    const __m128 cust_lon = _mm_set1_ps(p.longitude);
+    const __m128 wtp = _mm_set1_ps(p.willingness_to_pay);
+    const __m128 rating_w = _mm_set1_ps(p.rating_w);
+    const __m128 price_w = _mm_set1_ps(p.price_w);
+    const __m128 max_dist = _mm_set1_ps(stores.max_travel_distance);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 one_half = _mm_set1_ps(1.5f);
+    const __m128 too_far = _mm_set1_ps(-100.0f);
+    const float* novelty = p.novelty_by_category.data();
+    const float* lat = stores.latitude.data();
+    const float* lon = stores.longitude.data();
+    const float* rating = stores.rating.data();
+    const float* price = stores.price_per_bag.data();
+    const int* category = stores.category.data();
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int s0 = slots[i], s1 = slots[i + 1], s2 = slots[i + 2], s3 = slots[i + 3];
+        __m128 dlat = _mm_sub_ps(_mm_setr_ps(lat[s0], lat[s1], lat[s2], lat[s3]), cust_lat);
+        __m128 dlon = _mm_sub_ps(_mm_setr_ps(lon[s0], lon[s1], lon[s2], lon[s3]), cust_lon);
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dlat, dlat), _mm_mul_ps(dlon, dlon)));
+
+        __m128 rating_score = _mm_mul_ps(rating_w, _mm_setr_ps(rating[s0], rating[s1], rating[s2], rating[s3]));
+        __m128 price_score = _mm_div_ps(
+            _mm_mul_ps(price_w, _mm_sub_ps(wtp, _mm_setr_ps(price[s0], price[s1], price[s2], price[s3]))), wtp);
+        __m128 novelty_score = _mm_setr_ps(novelty[category[s0]], novelty[category[s1]],
+                                           novelty[category[s2]], novelty[category[s3]]);
+        __m128 distance_score = _mm_mul_ps(_mm_sub_ps(one, _mm_div_ps(distance, max_dist)), one_half);
+
+        __m128 total = _mm_add_ps(_mm_add_ps(_mm_add_ps(rating_score, price_score), novelty_score),
+                                  distance_score);
+        __m128 far = _mm_cmpgt_ps(distance, max_dist);
+        _mm_storeu_ps(&out[i], _mm_or_ps(_mm_and_ps(far, too_far), _mm_andnot_ps(far, total)));
+    }
+    score_slots_scalar(p, stores, slots + i, count - i, out + i);
+}
+#endif
+
+typedef void (*ScoreRangeFn)(const CustomerScoringParams&, const StoreTable&, int, int, float*);
+typedef void (*ScoreSlotsFn)(const CustomerScoringParams&, const StoreTable&, const int*, int, float*);
+
+static ScoringKernel detect_best_kernel() {
+#ifdef STORE_SCORING_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return ScoringKernel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return ScoringKernel::SSE2;
+#endif
+    return ScoringKernel::SCALAR;
+}
+
+static ScoringKernel& active_kernel() {
+    static ScoringKernel kernel = detect_best_kernel();
+    return kernel;
+}
+
+static ScoreRangeFn kernel_function(ScoringKernel kernel) {
+#ifdef STORE_SCORING_X86
+    if (kernel == ScoringKernel::AVX2) return score_range_avx2;
+    if (kernel == ScoringKernel::SSE2) return score_range_sse2;
+#endif
+    return score_range_scalar;
+}
+
+static ScoreSlotsFn slots_kernel_function(ScoringKernel kernel) {
+#ifdef STORE_SCORING_X86
+    if (kernel == ScoringKernel::AVX2) return score_slots_avx2;
+    if (kernel == ScoringKernel::SSE2) return score_slots_sse2;
+#endif
+    return score_slots_scalar;
+}
+
+void score_store_range(const CustomerScoringParams& params, const StoreTable& stores,
+                       int begin, int end, float* out) {
+    kernel_function(active_kernel())(params, stores, begin, end, out);
+}
+
+void score_all_stores(const Customer& customer, const StoreTable& stores, vector<float>& out) {
+    CustomerScoringParams params(customer, stores);
+    out.resize(stores.size());
+    score_store_range(params, stores, 0, stores.size(), out.data());
+}
+
+void score_store_slots(const CustomerScoringParams& params, const StoreTable& stores,
+                       const int* slots, int count, float* out) {
+    slots_kernel_function(active_kernel())(params, stores, slots, count, out);
+}
+
+// Requests for a kernel the CPU cannot run fall back to the best one it can
+void set_scoring_kernel(ScoringKernel kernel) {
+    ScoringKernel best = detect_best_kernel();
+    if (kernel == ScoringKernel::AUTO || (int)kernel > (int)best) {
+        kernel = best;
+    }
+    active_kernel() = kernel;
+}
+
+ScoringKernel get_scoring_kernel() {
+    return active_kernel();
+}
+
+const char* scoring_kernel_name(ScoringKernel kernel) {
+    switch (kernel) {
+        case ScoringKernel::AVX2: return "avx2";
+        case ScoringKernel::SSE2: return "sse2";
+        case ScoringKernel::SCALAR: return "scalar";
+        default: return "auto";
+    }
+}
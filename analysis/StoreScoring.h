@@ -0,0 +1,58 @@
+#ifndef STORE_SCORING_H
+#define STORE_SCORING_H
+
+#include <vector>
+#include "Customer.h"
+#include "StoreTable.h"
+
+using namespace std;
+
+// Batch Store Scoring
+// Scores one customer against a contiguous range of store slots in a single
+// pass over the StoreTable columns. Produces exactly the same values as
+// Customer::calculate_store_score (including -100 beyond the table's
+// max_travel_distance).
+// The kernel is picked once at runtime: AVX2 (8 lanes), SSE2 (4 lanes) or
+// a scalar loop on other targets.
+
+enum class ScoringKernel {
+    AUTO,
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Per-customer constants hoisted out of the store loop
+struct CustomerScoringParams {
+    float latitude;
+    float longitude;
+    float willingness_to_pay;
+    float rating_w;
+    float price_w;
+    vector<float> novelty_by_category;  // indexed by StoreTable category id
+
+    CustomerScoringParams();
+    CustomerScoringParams(const Customer& customer, const StoreTable& stores);
+
+    // Recompute for another customer, reusing the novelty buffer
+    void load(const Customer& customer, const StoreTable& stores);
+};
+
+// Score slots [begin, end) into out[0 .. end-begin)
+void score_store_range(const CustomerScoringParams& params, const StoreTable& stores,
+                       int begin, int end, float* out);
+
+// Score every store in the table into out (resized to stores.size())
+void score_all_stores(const Customer& customer, const StoreTable& stores, vector<float>& out);
+
+// Score an arbitrary list of slots: out[i] is the score of slots[i].
+// Uses the same kernel as ranges, gathering the columns by slot.
+void score_store_slots(const CustomerScoringParams& params, const StoreTable& stores,
+                       const int* slots, int count, float* out);
+
+// Kernel selection (AUTO = best supported by this CPU)
+void set_scoring_kernel(ScoringKernel kernel);
+ScoringKernel get_scoring_kernel();
+const char* scoring_kernel_name(ScoringKernel kernel);
+
+#endif // STORE_SCORING_H
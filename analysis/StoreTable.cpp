@@ -0,0 +1,54 @@
+#include "StoreTable.h"
+#include <algorithm>
+
+using namespace std;
+
+// Distance threshold defined in Customer.cpp
+extern const float MAX_TRAVEL_DISTANCE;
+
+StoreTable::StoreTable() : num_categories(0), max_travel_distance(MAX_TRAVEL_DISTANCE) {}
+
+void StoreTable::build(const vector<Restaurant>& restaurants) {
+    int n = (int)restaurants.size();
+    business_id.resize(n);
+    latitude.resize(n);
+    longitude.resize(n);
+    price_per_bag.resize(n);
+    rating.resize(n);
+    estimated_bags.resize(n);
+    reserved_count.resize(n);
+    has_inventory.resize(n);
+    category.resize(n);
+    num_categories = 0;
+
+    for (int slot = 0; slot < n; slot++) {
+        const Restaurant& r = restaurants[slot];
+        business_id[slot] = r.business_id;
+        latitude[slot] = r.latitude;
+        longitude[slot] = r.longitude;
+        price_per_bag[slot] = r.price_per_bag;
+        estimated_bags[slot] = r.estimated_bags;
+        category[slot] = r.category_id;
+        num_categories = max(num_categories, r.category_id + 1);
+        refresh(slot, r);
+    }
+}
+
+// Only the fields the simulation mutates during a run
+void StoreTable::refresh(int slot, const Restaurant& restaurant) {
+    rating[slot] = restaurant.get_rating();
+    reserved_count[slot] = restaurant.reserved_count;
+    has_inventory[slot] = restaurant.has_inventory ? 1 : 0;
+}
+
+int StoreTable::size() const {
+    return (int)business_id.size();
+}
+
+bool StoreTable::can_accept_reservation(int slot) const {
+    return has_inventory[slot] && (reserved_count[slot] < estimated_bags[slot]);
+}
+
+int StoreTable::unsold_bags(int slot) const {
+    return max(0, estimated_bags[slot] - reserved_count[slot]);
+}
@@ -0,0 +1,50 @@
+#ifndef STORE_TABLE_H
+#define STORE_TABLE_H
+
+#include <vector>
+#include <string>
+#include "AlignedAllocator.h"
+#include "Restaurant.h"
+
+using namespace std;
+
+// Store Table
+// Column-oriented copy of the fields the scoring loops read for every
+// candidate store (indexed by slot). MarketState owns the table and
+// refreshes a row whenever the matching Restaurant changes, so the hot
+// loops stream contiguous arrays instead of walking Restaurant objects.
+class StoreTable {
+public:
+    template <class T>
+    using Column = vector<T, AlignedAllocator<T>>;
+
+    Column<int> business_id;
+    Column<float> latitude;
+    Column<float> longitude;
+    Column<float> price_per_bag;
+    Column<float> rating;
+    Column<int> estimated_bags;
+    Column<int> reserved_count;
+    Column<unsigned char> has_inventory;
+    Column<int> category;              // interned category id
+    int num_categories;                // 1 + largest category id in the table
+    float max_travel_distance;         // pickup radius of the market (set by MarketState)
+
+    StoreTable();
+
+    // Rebuild all columns from the catalog
+    void build(const vector<Restaurant>& restaurants);
+
+    // Copy one store's mutable fields back into the columns
+    void refresh(int slot, const Restaurant& restaurant);
+
+    int size() const;
+
+    // Same rule as Restaurant::can_accept_reservation
+    bool can_accept_reservation(int slot) const;
+
+    // Bags not yet reserved (never negative)
+    int unsold_bags(int slot) const;
+};
+
+#endif // STORE_TABLE_H
@@ -0,0 +1,111 @@
+#include "ThreadPool.h"
+
+using namespace std;
+
+// Which pool and deque the current thread works for (none outside workers)
+static thread_local const ThreadPool* current_pool = nullptr;
+static thread_local int current_worker = -1;
+
+ThreadPool::ThreadPool(int num_threads) : next_queue(0), queued(0), unfinished(0), stopping(false) {
+    if (num_threads <= 0) num_threads = default_thread_count();
+    for (int i = 0; i < num_threads; i++) {
+        queues.push_back(unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    for (int i = 0; i < num_threads; i++) {
+        workers.push_back(thread(&ThreadPool::worker_loop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(state_mutex);
+        stopping = true;
+    }
+    task_ready.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(const function<void()>& task) {
+    int target = (current_pool == this) ? current_worker
+                                        : (int)(next_queue++ % queues.size());
+    // Counted as unfinished before it can run, so a quick task cannot
+    // bring the count to zero while its submitter is still running
+    {
+        lock_guard<mutex> lock(state_mutex);
+        unfinished++;
+    }
+    {
+        lock_guard<mutex> lock(queues[target]->lock);
+        queues[target]->tasks.push_back(task);
+    }
+    {
+        // Published under the state mutex so a worker about to sleep sees it
+        lock_guard<mutex> lock(state_mutex);
+        queued++;
+    }
+    task_ready.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> lock(state_mutex);
+    all_done.wait(lock, [this] { return unfinished == 0; });
+}
+
+int ThreadPool::size() const {
+    return (int)workers.size();
+}
+
+int ThreadPool::default_thread_count() {
+    int n = (int)thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+// Own deque from the back (newest, cache-warm), others from the front
+bool ThreadPool::take_task(int index, function<void()>& task) {
+    {
+        WorkerQueue& own = *queues[index];
+        lock_guard<mutex> lock(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    int n = (int)queues.size();
+    for (int k = 1; k < n; k++) {
+        WorkerQueue& victim = *queues[(index + k) % n];
+        lock_guard<mutex> lock(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(int index) {
+    current_pool = this;
+    current_worker = index;
+
+    while (true) {
+        function<void()> task;
+        if (!take_task(index, task)) {
+            unique_lock<mutex> lock(state_mutex);
+            task_ready.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping && queued == 0) return;
+            continue;
+        }
+
+        task();
+
+        lock_guard<mutex> lock(state_mutex);
+        if (--unfinished == 0) {
+            all_done.notify_all();
+        }
+    }
+}
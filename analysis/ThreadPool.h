@@ -0,0 +1,64 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// Thread Pool
+// Work-stealing pool: every worker owns a deque. Tasks submitted from
+// outside are dealt round-robin across the deques; tasks submitted from a
+// worker go to its own deque. A worker takes its newest task first and,
+// when its deque is empty, steals the oldest task of another worker, so a
+// few long jobs never leave the other threads idle behind them.
+// Tasks must not share mutable state; callers give each task its own
+// output slot and read the results after wait().
+class ThreadPool {
+public:
+    // 0 threads = one per hardware thread
+    explicit ThreadPool(int num_threads = 0);
+    ~ThreadPool();
+
+    void submit(const function<void()>& task);
+
+    // Block until every submitted task has finished
+    void wait();
+
+    int size() const;
+
+    // Hardware threads, at least 1
+    static int default_thread_count();
+
+private:
+    struct WorkerQueue {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<WorkerQueue>> queues;
+    vector<thread> workers;
+    atomic<unsigned> next_queue;   // round-robin target for outside submits
+    atomic<int> queued;            // tasks sitting in some deque
+
+    // Sleep/wake and completion tracking
+    mutex state_mutex;
+    condition_variable task_ready;
+    condition_variable all_done;
+    int unfinished;
+    bool stopping;
+
+    void worker_loop(int index);
+    bool take_task(int index, function<void()>& task);
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif // THREAD_POOL_H
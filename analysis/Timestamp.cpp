@@ -2,18 +2,29 @@
 
 using namespace std;
 
-Timestamp::Timestamp(int h, int m) : hour(h), minute(m) {}
+Timestamp::Timestamp(int h, int m, int s) : hour(h), minute(m), second(s) {}
 
 int Timestamp::to_minutes() const {
     return hour * 60 + minute;
 }
 
+int Timestamp::to_seconds() const {
+    return to_minutes() * 60 + second;
+}
+
+Timestamp Timestamp::from_seconds(int seconds) {
+    return Timestamp(seconds / 3600, (seconds / 60) % 60, seconds % 60);
+}
+
 bool Timestamp::operator<(const Timestamp& other) const {
-    return to_minutes() < other.to_minutes();
+    return to_seconds() < other.to_seconds();
 }
 
 string Timestamp::to_string() const {
-    return std::to_string(hour) + ":" +
+    string text = std::to_string(hour) + ":" +
         (minute < 10 ? "0" : "") + std::to_string(minute);
+    if (second != 0) {
+        text += (second < 10 ? ":0" : ":") + std::to_string(second);
+    }
+    return text;
 }
-
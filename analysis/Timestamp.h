@@ -9,19 +9,23 @@ using namespace std;
 struct Timestamp {
     int hour;
     int minute;
+    int second;
 
     // Constructor
-    Timestamp(int h = 8, int m = 0);
+    Timestamp(int h = 8, int m = 0, int s = 0);
 
-    // Convert to minutes
+    // Convert to minutes (seconds dropped)
     int to_minutes() const;
 
+    // Convert to seconds since midnight, and back
+    int to_seconds() const;
+    static Timestamp from_seconds(int seconds);
+
     // Comparison
     bool operator<(const Timestamp& other) const;
 
-    // Convert to string
+    // Convert to string (H:MM, or H:MM:SS when seconds are set)
     string to_string() const;
 };
 
 #endif // TIMESTAMP_H
-
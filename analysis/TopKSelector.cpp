@@ -0,0 +1,62 @@
+#include "TopKSelector.h"
+#include <algorithm>
+
+using namespace std;
+
+TopKSelector::TopKSelector(int k) : k(0), is_sorted(false) {
+    reset(k);
+}
+
+void TopKSelector::reset(int new_k) {
+    k = max(0, new_k);
+    is_sorted = false;
+    heap.clear();
+    heap.reserve(k);
+}
+
+bool TopKSelector::ranks_before(const pair<int, float>& a, const pair<int, float>& b) {
+    if (a.second != b.second) return a.second > b.second;
+    return a.first < b.first;
+}
+
+// "Less" for the heap means "ranks better", so the worst entry sits on top
+void TopKSelector::offer(int slot, float score) {
+    pair<int, float> entry(slot, score);
+    if ((int)heap.size() < k) {
+        heap.push_back(entry);
+        push_heap(heap.begin(), heap.end(), ranks_before);
+    } else if (k > 0 && ranks_before(entry, heap.front())) {
+        pop_heap(heap.begin(), heap.end(), ranks_before);
+        heap.back() = entry;
+        push_heap(heap.begin(), heap.end(), ranks_before);
+    }
+}
+
+bool TopKSelector::accepts(int slot, float score) const {
+    if ((int)heap.size() < k) return true;
+    return k > 0 && ranks_before(make_pair(slot, score), heap.front());
+}
+
+int TopKSelector::size() const {
+    return (int)heap.size();
+}
+
+int TopKSelector::capacity() const {
+    return k;
+}
+
+bool TopKSelector::full() const {
+    return (int)heap.size() >= k;
+}
+
+const pair<int, float>& TopKSelector::worst() const {
+    return heap.front();
+}
+
+const vector<pair<int, float>>& TopKSelector::sorted() {
+    if (!is_sorted) {
+        sort_heap(heap.begin(), heap.end(), ranks_before);
+        is_sorted = true;
+    }
+    return heap;
+}
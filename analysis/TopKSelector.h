@@ -0,0 +1,47 @@
+#ifndef TOP_K_SELECTOR_H
+#define TOP_K_SELECTOR_H
+
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+// Top-K Selector
+// Keeps the K best (slot, score) pairs seen so far in a bounded heap, so a
+// ranking pass over S stores costs O(S log K) instead of a full sort.
+// Order: higher score first, ties broken by lower slot (catalog order),
+// which matches a stable sort of the candidates in slot order.
+class TopKSelector {
+public:
+    // Constructor
+    explicit TopKSelector(int k = 0);
+
+    // Clear and set a new capacity
+    void reset(int k);
+
+    // Offer a candidate
+    void offer(int slot, float score);
+
+    // Would a candidate with this score/slot make the cut?
+    bool accepts(int slot, float score) const;
+
+    int size() const;
+    int capacity() const;
+    bool full() const;
+
+    // Current K-th best entry (only valid when full)
+    const pair<int, float>& worst() const;
+
+    // Entries in best-first order; the selector must be reset before reuse
+    const vector<pair<int, float>>& sorted();
+
+    // Ranking order shared with callers that merge candidate lists
+    static bool ranks_before(const pair<int, float>& a, const pair<int, float>& b);
+
+private:
+    int k;
+    bool is_sorted;
+    vector<pair<int, float>> heap;  // worst entry at heap[0]
+};
+
+#endif // TOP_K_SELECTOR_H
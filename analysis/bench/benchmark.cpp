@@ -0,0 +1,587 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <algorithm>
+#include "RankingAlgorithms.h"
+#include "BatchRanking.h"
+#include "CustomerDecisionSystem.h"
+#include "RestaurantManagementSystem.h"
+#include "SimulationEngine.h"
+#include "Metrics.h"
+#include "RestaurantLoader.h"
+#include "ArrivalGenerator.h"
+#include "ArrivalProfile.h"
+#include "ScenarioGenerator.h"
+#include "Experiment.h"
+#include "ParameterSweep.h"
+
+using namespace std;
+
+// Microbenchmarks
+// Times the hot calls of a simulated day on synthetic markets of the
+// requested sizes (fitted to stores.csv / customer.csv when present) and
+// writes one JSON record per case: ns/op, heap allocations and bytes per
+// op, and ops/s. Only the measured call is timed and counted; the state it
+// consumes is rebuilt untimed before each round.
+
+// ============================================================================
+// ALLOCATION COUNTER
+// ============================================================================
+// Every operator new in the process goes through here. The deletes stay
+// out of line so GCC does not pair the inlined free() with a new-expression.
+
+#ifdef __GNUC__
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+static atomic<long long> allocation_count(0);
+static atomic<long long> allocated_bytes(0);
+
+void* operator new(size_t size) {
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    allocated_bytes.fetch_add((long long)size, memory_order_relaxed);
+    void* p = malloc(size > 0 ? size : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+BENCH_NOINLINE void operator delete(void* p) noexcept {
+    free(p);
+}
+
+BENCH_NOINLINE void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+// ============================================================================
+// HARNESS
+// ============================================================================
+
+struct BenchOptions {
+    vector<int> stores;
+    vector<int> customers;
+    vector<int> reservations;
+    vector<int> n_displayed;
+    double min_seconds;
+    string filter;
+    string output;
+    uint64_t seed;
+
+    BenchOptions()
+        : stores({100, 1000, 10000}), customers({10000}), reservations({1000, 10000}),
+          n_displayed({5, 20}), min_seconds(0.25), output("benchmark_results.json"),
+          seed(DEFAULT_SIMULATION_SEED) {}
+};
+
+typedef vector<pair<string, long long>> BenchParams;
+
+struct BenchResult {
+    string name;
+    BenchParams params;
+    int rounds;
+    long long ops;
+    double seconds;
+    long long allocations;
+    long long bytes;
+};
+
+static BenchOptions options;
+static vector<BenchResult> results;
+
+// Results are folded in here so the compiler cannot drop the measured calls
+static volatile float sink;
+
+static bool selected(const string& name) {
+    return options.filter.empty() || name.find(options.filter) != string::npos;
+}
+
+// Run setup + body until the bodies add up to min_seconds (three rounds at
+// least); body performs ops_per_round operations
+static void measure(const string& name, const BenchParams& params, long long ops_per_round,
+                    const function<void()>& setup, const function<void()>& body) {
+    BenchResult result;
+    result.name = name;
+    result.params = params;
+    result.rounds = 0;
+    result.ops = 0;
+    result.seconds = 0.0;
+    result.allocations = 0;
+    result.bytes = 0;
+
+    while (result.rounds < 3 || result.seconds < options.min_seconds) {
+        if (setup) setup();
+        long long allocations = allocation_count.load(memory_order_relaxed);
+        long long bytes = allocated_bytes.load(memory_order_relaxed);
+        auto start = chrono::steady_clock::now();
+        body();
+        auto stop = chrono::steady_clock::now();
+        result.allocations += allocation_count.load(memory_order_relaxed) - allocations;
+        result.bytes += allocated_bytes.load(memory_order_relaxed) - bytes;
+        result.seconds += chrono::duration<double>(stop - start).count();
+        result.ops += ops_per_round;
+        result.rounds++;
+    }
+
+    double ops = (double)max(result.ops, 1LL);
+    cerr << "  " << left << setw(28) << name;
+    for (const auto& p : params) cerr << " " << p.first << "=" << p.second;
+    cerr << "  " << fixed << setprecision(1) << result.seconds * 1e9 / ops << " ns/op, "
+         << setprecision(2) << result.allocations / ops << " allocs/op" << endl;
+    cerr.unsetf(ios::fixed);
+    results.push_back(result);
+}
+
+static void write_json(ostream& out) {
+    out << "{\n  \"min_seconds\": " << options.min_seconds
+        << ",\n  \"seed\": " << options.seed << ",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        double ops = (double)max(r.ops, 1LL);
+        out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\", \"params\": {";
+        for (size_t p = 0; p < r.params.size(); p++) {
+            out << (p ? ", " : "") << "\"" << r.params[p].first << "\": " << r.params[p].second;
+        }
+        out << "}, \"rounds\": " << r.rounds << ", \"ops\": " << r.ops
+            << ", \"seconds\": " << r.seconds
+            << ", \"ns_per_op\": " << r.seconds * 1e9 / ops
+            << ", \"allocs_per_op\": " << r.allocations / ops
+            << ", \"bytes_per_op\": " << r.bytes / ops
+            << ", \"ops_per_sec\": " << (r.seconds > 0.0 ? r.ops / r.seconds : 0.0) << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// Silence the loaders' progress messages while they are measured
+class MuteStdout {
+public:
+    MuteStdout() : saved(cout.rdbuf(nullptr)) {}
+    ~MuteStdout() { cout.rdbuf(saved); }
+private:
+    streambuf* saved;
+};
+
+// ============================================================================
+// MARKETS
+// ============================================================================
+
+static ScenarioFit sample_fit() {
+    MuteStdout mute;
+    vector<Restaurant> stores;
+    if (!RestaurantLoader::load_restaurants_from_csv("stores.csv", stores)) {
+        RestaurantLoader::generate_default_restaurants(stores);
+    }
+    ArrivalGenerator generator(options.seed);
+    generator.load_customers_from_csv("customer.csv");
+    return fit_scenario(stores, generator.get_customers());
+}
+
+static Scenario make_scenario(const ScenarioFit& fit, int store_count, int customer_count) {
+    ScenarioSpec spec;
+    spec.store_count = store_count;
+    spec.customer_count = customer_count;
+    spec.seed = options.seed;
+    return generate_scenario(fit, spec);
+}
+
+// Market with up to reservation_count pending reservations and the day's
+// inventory revealed, as it stands when trading closes. Stores are given
+// enough expected bags to take every reservation.
+static MarketState make_closing_market(const Scenario& scenario, int reservation_count) {
+    vector<Restaurant> stores = scenario.stores;
+    long long capacity = 0;
+    for (const auto& r : stores) capacity += r.estimated_bags;
+    int factor = (int)((reservation_count + capacity - 1) / max(capacity, 1LL));
+    if (factor > 1) {
+        for (auto& r : stores) r.estimated_bags *= factor;
+    }
+
+    MarketState market;
+    market.set_restaurants(stores);
+    for (const auto& c : scenario.customers) {
+        market.customers[c.id] = c;
+    }
+
+    RandomStream rng(options.seed, StreamPurpose::STORE_CHOICE, 0, 0);
+    int customer_count = (int)scenario.customers.size();
+    int store_count = market.get_restaurant_count();
+    for (int made = 0, attempts = 0; made < reservation_count && attempts < 4 * reservation_count; attempts++) {
+        market.current_time = Timestamp::from_seconds(8 * 3600 + attempts * 50400LL / (4 * reservation_count));
+        Customer& customer = market.customers[scenario.customers[rng() % customer_count].id];
+        int slot = rng() % store_count;
+        if (CustomerDecisionSystem::create_reservation(customer, market.restaurant_at(slot).business_id, market)) {
+            made++;
+        }
+    }
+
+    RandomStream inventory(options.seed, StreamPurpose::INVENTORY, 1, 0);
+    uniform_real_distribution<float> variance(0.7f, 1.3f);
+    for (int slot = 0; slot < store_count; slot++) {
+        Restaurant& r = market.restaurant_at(slot);
+        r.set_actual_inventory(max(0, (int)(r.estimated_bags * variance(inventory))));
+    }
+    return market;
+}
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+static const int ARRIVALS_PER_ROUND = 1000;
+
+static void bench_ranking(const Scenario& scenario, int n_displayed) {
+    MarketState market;
+    market.set_restaurants(scenario.stores);
+    const vector<Customer>& customers = scenario.customers;
+    BenchParams params = {{"stores", (long long)scenario.stores.size()}, {"displayed", n_displayed}};
+
+    ArrivalContext context;
+    for (const auto& algo : ranking_algorithms()) {
+        string name = "rank/" + algo.first;
+        if (!selected(name)) continue;
+        size_t next = 0;
+        measure(name, params, ARRIVALS_PER_ROUND, nullptr, [&]() {
+            for (int i = 0; i < ARRIVALS_PER_ROUND; i++) {
+                const Customer& customer = customers[next++ % customers.size()];
+                sink = (float)get_displayed_stores(customer, market, n_displayed, algo.second, context).size();
+            }
+        });
+    }
+
+    // Same arrivals ranked a block at a time; slates and sampled choices
+    // must match one by one
+    vector<Customer> block(ARRIVALS_PER_ROUND);
+    for (const auto& algo : ranking_algorithms()) {
+        string name = "rank_batch/" + algo.first;
+        if (!selected(name)) continue;
+        for (int i = 0; i < ARRIVALS_PER_ROUND; i++) block[i] = customers[i % customers.size()];
+        vector<int> choices;
+        vector<vector<int>> slates = rank_customer_batch(block, market, n_displayed, algo.second,
+                                                         options.seed, 0, choices);
+        for (int i = 0; i < ARRIVALS_PER_ROUND; i++) {
+            if (slates[i] != get_displayed_stores(block[i], market, n_displayed, algo.second, context)) {
+                cerr << name << ": batch slate differs from single arrival for customer " << i << endl;
+                exit(1);
+            }
+            RandomStream rng(options.seed, StreamPurpose::STORE_CHOICE, 0, block[i].id);
+            if (choices[i] != CustomerDecisionSystem::select_store(block[i], context.slate_ids,
+                                                                   context.slate_scores, market, rng)) {
+                cerr << name << ": batch choice differs from select_store for customer " << i << endl;
+                exit(1);
+            }
+        }
+        size_t next = 0;
+        measure(name, params, ARRIVALS_PER_ROUND, [&]() {
+            for (int i = 0; i < ARRIVALS_PER_ROUND; i++) block[i] = customers[next++ % customers.size()];
+        }, [&]() {
+            sink = (float)rank_customer_batch(block, market, n_displayed, algo.second).size();
+        });
+    }
+}
+
+static void bench_scoring(const Scenario& scenario) {
+    MarketState market;
+    market.set_restaurants(scenario.stores);
+    const vector<Customer>& customers = scenario.customers;
+    int store_count = market.get_restaurant_count();
+    float distance = market.get_travel_distance();
+    BenchParams params = {{"stores", store_count}};
+
+    // One op scores one store for one customer
+    size_t next = 0;
+    if (selected("score/restaurant")) {
+        measure("score/restaurant", params, store_count, nullptr, [&]() {
+            const Customer& customer = customers[next++ % customers.size()];
+            float total = 0.0f;
+            for (const auto& r : market.restaurants) {
+                total += customer.calculate_store_score(r, distance);
+            }
+            sink = total;
+        });
+    }
+    if (selected("score/table")) {
+        const StoreTable& table = market.get_store_table();
+        measure("score/table", params, store_count, nullptr, [&]() {
+            const Customer& customer = customers[next++ % customers.size()];
+            float total = 0.0f;
+            for (int slot = 0; slot < store_count; slot++) {
+                total += customer.calculate_store_score(table, slot);
+            }
+            sink = total;
+        });
+    }
+}
+
+static void bench_selection(int n_displayed) {
+    if (!selected("probabilistic_select")) return;
+    vector<int> store_ids(n_displayed);
+    vector<float> scores(n_displayed);
+    vector<int> valid_indices(n_displayed);
+    RandomStream values(options.seed, StreamPurpose::STORE_CHOICE, 0, 1);
+    uniform_real_distribution<float> score(-2.0f, 8.0f);
+    for (int i = 0; i < n_displayed; i++) {
+        store_ids[i] = i + 1;
+        scores[i] = score(values);
+        valid_indices[i] = i;
+    }
+
+    RandomStream rng(options.seed, StreamPurpose::STORE_CHOICE, 0, 2);
+    measure("probabilistic_select", {{"displayed", n_displayed}}, ARRIVALS_PER_ROUND, nullptr, [&]() {
+        int total = 0;
+        for (int i = 0; i < ARRIVALS_PER_ROUND; i++) {
+            total += CustomerDecisionSystem::probabilistic_select(store_ids, scores, valid_indices, scores, rng);
+        }
+        sink = (float)total;
+    });
+}
+
+static void bench_end_of_day(const Scenario& scenario, int reservation_count) {
+    bool settle = selected("process_end_of_day");
+    bool log = selected("log_end_of_day");
+    if (!settle && !log) return;
+
+    MarketState closing = make_closing_market(scenario, reservation_count);
+    BenchParams params = {{"stores", (long long)scenario.stores.size()},
+                          {"reservations", (long long)closing.reservations.size()}};
+
+    // One op settles (or accounts for) one reservation
+    MarketState market;
+    if (settle) {
+        measure("process_end_of_day", params, closing.reservations.size(),
+                [&]() { market = closing; },
+                [&]() { RestaurantManagementSystem::process_end_of_day(market); });
+    }
+    if (log) {
+        market = closing;
+        RestaurantManagementSystem::process_end_of_day(market);
+        MetricsCollector collector;
+        measure("log_end_of_day", params, market.reservations.size(), nullptr,
+                [&]() { collector.log_end_of_day(market); });
+        sink = collector.metrics.total_revenue_generated;
+    }
+}
+
+// Whole days on the event queue. Every reservation has to come out of the
+// day confirmed or cancelled, including those made by arrivals at closing
+// time, which must be served before the day settles.
+static void bench_day_schedule(const string& prefix, const Scenario& scenario, int n_displayed,
+                               const vector<Customer>& customers, const vector<Timestamp>& times,
+                               const BenchParams& params) {
+    int arrivals = (int)customers.size();
+    ostringstream log;
+    for (const auto& algo : ranking_algorithms()) {
+        string name = prefix + algo.first;
+        if (!selected(name)) continue;
+        unique_ptr<SimulationEngine> engine;
+        auto setup = [&]() {
+            engine.reset(new SimulationEngine(n_displayed, "", algo.second, options.seed));
+            engine->set_output_stream(&log);
+            engine->set_customer_pool(customers);
+            engine->set_arrival_times(vector<vector<Timestamp>>(1, times));
+            engine->initialize(scenario.stores);
+            log.str("");
+        };
+        setup();
+        engine->run_multi_day_simulation(1, arrivals);
+        for (const auto& res : engine->get_market_state().reservations) {
+            if (res.status == Reservation::PENDING) {
+                cerr << name << ": reservation " << res.reservation_id
+                     << " is still pending after the day closed" << endl;
+                exit(1);
+            }
+        }
+        measure(name, params, arrivals, setup, [&]() {
+            engine->run_multi_day_simulation(1, arrivals);
+        });
+    }
+}
+
+// run_day/ spreads the arrivals over the day with the last tenth exactly at
+// closing time. run_day_peak/ sends them at the busiest minute's rate of
+// the built-in weekday curve, taking the scenario's customers as one day's
+// arrivals, in a burst that ends at closing time.
+static void bench_day(const Scenario& scenario, int n_displayed) {
+    int arrivals = min(ARRIVALS_PER_ROUND, (int)scenario.customers.size());
+    if (arrivals < 2) return;
+    vector<Customer> customers(scenario.customers.begin(), scenario.customers.begin() + arrivals);
+    int open = Timestamp(8, 0).to_seconds();
+    int close = Timestamp(22, 0).to_seconds();
+    BenchParams params = {{"stores", (long long)scenario.stores.size()}, {"displayed", n_displayed},
+                          {"arrivals", arrivals}};
+
+    int spread = arrivals - arrivals / 10;
+    vector<Timestamp> times(arrivals, Timestamp::from_seconds(close));
+    for (int i = 0; i < spread; i++) {
+        times[i] = Timestamp::from_seconds(open + (int)((long long)(close - open) * i / spread));
+    }
+    bench_day_schedule("run_day/", scenario, n_displayed, customers, times, params);
+
+    double per_minute = WeeklyArrivalProfile::meal_peaks().for_day(0).peak_share_per_minute() *
+                        scenario.customers.size();
+    double gap = 60.0 / max(per_minute, 1.0 / 60.0);
+    for (int i = 0; i < arrivals; i++) {
+        times[i] = Timestamp::from_seconds(max(open, close - (int)((arrivals - 1 - i) * gap)));
+    }
+    params.push_back(make_pair(string("arrivals_per_minute"), (long long)(per_minute + 0.5)));
+    bench_day_schedule("run_day_peak/", scenario, n_displayed, customers, times, params);
+}
+
+static void write_stores_csv(const string& path, const vector<Restaurant>& stores) {
+    ofstream out(path);
+    out << "store_id,store_name,branch,average_bags_at_9AM,average_overall_rating,price,"
+        << "longitude,latitude,business_type\n";
+    for (const auto& r : stores) {
+        out << r.business_id << "," << r.business_name << "," << r.branch << ","
+            << r.estimated_bags << "," << r.general_ranking << "," << r.price_per_bag << ","
+            << setprecision(8) << r.longitude << "," << r.latitude << setprecision(6) << ","
+            << r.business_type << "\n";
+    }
+}
+
+// Same layout as the bundled customer.csv (15 store valuation columns)
+static void write_customers_csv(const string& path, const vector<Customer>& customers) {
+    static const int VALUATION_COLUMNS = 15;
+    ofstream out(path);
+    out << "CustomerID,longitude,latitude,segment,willingness_to_pay,rating_weight,"
+        << "price_weight,novelty_weight,leaving_threshold";
+    for (int s = 1; s <= VALUATION_COLUMNS; s++) out << ",store" << s << "_id_valuation";
+    out << "\n";
+    RandomStream rng(options.seed, StreamPurpose::CSV_FILL, 0, 0);
+    for (const auto& c : customers) {
+        out << c.id << "," << setprecision(8) << c.longitude << "," << c.latitude << setprecision(6)
+            << "," << segment_name(c.segment) << "," << c.willingness_to_pay << ","
+            << c.weights.rating_w << "," << c.weights.price_w << "," << c.weights.novelty_w << ","
+            << c.leaving_threshold;
+        for (int s = 0; s < VALUATION_COLUMNS; s++) out << "," << rng.uniform();
+        out << "\n";
+    }
+}
+
+static void bench_loaders(const Scenario& scenario, bool stores, bool customers) {
+    if (stores && selected("load/stores")) {
+        string path = "benchmark_stores.csv";
+        write_stores_csv(path, scenario.stores);
+        MuteStdout mute;
+        measure("load/stores", {{"stores", (long long)scenario.stores.size()}}, scenario.stores.size(),
+                nullptr, [&]() {
+            vector<Restaurant> loaded;
+            RestaurantLoader::load_restaurants_from_csv(path, loaded);
+            sink = (float)loaded.size();
+        });
+        remove(path.c_str());
+    }
+    if (customers && selected("load/customers")) {
+        string path = "benchmark_customers.csv";
+        write_customers_csv(path, scenario.customers);
+        MuteStdout mute;
+        measure("load/customers", {{"customers", (long long)scenario.customers.size()}},
+                scenario.customers.size(), nullptr, [&]() {
+            ArrivalGenerator generator(options.seed);
+            generator.load_customers_from_csv(path);
+            sink = (float)generator.get_customers().size();
+        });
+        remove(path.c_str());
+    }
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void print_usage(const char* program) {
+    cout << "Usage: " << program << " [options]\n"
+         << "  --stores N        store counts (default 100,1000,10000)\n"
+         << "  --customers M     customer counts (default 10000)\n"
+         << "  --reservations R  pending reservations at closing (default 1000,10000)\n"
+         << "  --displayed N     slate sizes (default 5,20)\n"
+         << "  --min-time X      seconds measured per case (default 0.25)\n"
+         << "  --filter TEXT     only cases whose name contains TEXT\n"
+         << "  --seed S          market seed (default " << DEFAULT_SIMULATION_SEED << ")\n"
+         << "  --output F        JSON results file, '-' for stdout\n"
+         << "                    (default benchmark_results.json)\n"
+         << "Value lists are 'a', 'a,b,c' or 'first:last[:step]'." << endl;
+}
+
+static bool parse_arguments(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        string value = argv[++i];
+        bool ok = true;
+        if (arg == "--stores") {
+            ok = parse_int_values(value, options.stores);
+        } else if (arg == "--customers") {
+            ok = parse_int_values(value, options.customers);
+        } else if (arg == "--reservations") {
+            ok = parse_int_values(value, options.reservations);
+        } else if (arg == "--displayed") {
+            ok = parse_int_values(value, options.n_displayed);
+        } else if (arg == "--min-time") {
+            options.min_seconds = atof(value.c_str());
+            ok = options.min_seconds > 0.0;
+        } else if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--seed") {
+            options.seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            ok = false;
+        }
+        if (!ok) return false;
+    }
+    for (const vector<int>* list : {&options.stores, &options.customers,
+                                    &options.reservations, &options.n_displayed}) {
+        for (int v : *list) if (v < 1) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (!parse_arguments(argc, argv)) {
+        print_usage(argv[0]);
+        return (argc == 2 && string(argv[1]) == "--help") ? 0 : 1;
+    }
+
+    ScenarioFit fit = sample_fit();
+    for (size_t s = 0; s < options.stores.size(); s++) {
+        for (size_t c = 0; c < options.customers.size(); c++) {
+            Scenario scenario = make_scenario(fit, options.stores[s], options.customers[c]);
+            cerr << scenario.stores.size() << " stores, " << scenario.customers.size() << " customers" << endl;
+
+            // Cases that do not depend on the customer count run once per store count
+            if (c == 0) {
+                for (int n : options.n_displayed) bench_ranking(scenario, n);
+                bench_scoring(scenario);
+                for (int r : options.reservations) bench_end_of_day(scenario, r);
+                for (int n : options.n_displayed) bench_day(scenario, n);
+            }
+            bench_loaders(scenario, c == 0, s == 0);
+        }
+    }
+    for (int n : options.n_displayed) bench_selection(n);
+
+    if (options.output == "-") {
+        write_json(cout);
+    } else {
+        ofstream out(options.output);
+        write_json(out);
+        cerr << "Results written to " << options.output << endl;
+    }
+    return 0;
+}
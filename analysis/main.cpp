@@ -3,25 +3,43 @@
 #include <fstream>
 #include <vector>
 #include <sstream>
+#include <algorithm>
+#include <cstdlib>
 #include "Restaurant.h"
 #include "RestaurantLoader.h"
 #include "SimulationEngine.h"
 #include "RankingAlgorithms.h"
+#include "ThreadPool.h"
+#include "ReplicationStats.h"
+#include "Experiment.h"
+#include "ParameterSweep.h"
+#include "ScenarioGenerator.h"
+#include <chrono>
 
 using namespace std;
 
 // Generate a detailed comparison report
+// Single-run tables come from the first replication; with more than one
+// replication the cross-seed statistics are appended
 void write_comparison_report(const vector<pair<string, SimulationMetrics>>& all_metrics, 
-                            const string& filename) {
+                            const string& filename,
+                            const ScenarioConfig& config,
+                            const vector<vector<SimulationMetrics>>* replicated_runs,
+                            const vector<string>& algorithm_names) {
     ofstream out(filename);
     
     out << "======================================================================\n";
     out << "FOOD WASTE MARKETPLACE SIMULATION - ALGORITHM COMPARISON REPORT\n";
     out << "======================================================================\n\n";
     
-    out << "Simulation Period: 7 Days\n";
-    out << "Customers per Day: 100\n";
-    out << "Total Customers: 700\n\n";
+    out << "Simulation Period: " << config.days << " Days\n";
+    out << "Customers per Day: " << config.customers_per_day << "\n";
+    out << "Total Customers: " << config.days * config.customers_per_day << "\n";
+    if (replicated_runs) {
+        out << "Replications: " << replicated_runs->front().size()
+            << " (single-run tables use the first seed)\n";
+    }
+    out << "\n";
     
     out << string(100, '=') << "\n";
     out << "OVERALL METRICS COMPARISON\n";
@@ -205,14 +223,138 @@ void write_comparison_report(const vector<pair<string, SimulationMetrics>>& all_
     }
     
     out << string(100, '=') << "\n";
+
+    if (replicated_runs) {
+        out << "\n";
+        write_replication_summary(out, algorithm_names, *replicated_runs);
+    }
     out.close();
 }
 
-int main() {
+// Per-run phase breakdown, one table per (algorithm, replication)
+static void write_phase_report(const string& filename, const vector<string>& algorithm_names,
+                               uint64_t base_seed, const vector<vector<PhaseTimes>>& phases) {
+    ofstream out(filename);
+    out << "======================================================================\n";
+    out << "FOOD WASTE MARKETPLACE SIMULATION - PHASE TIMING REPORT\n";
+    out << "======================================================================\n";
+    out << "Exclusive time per phase; \"other\" is the untimed rest of the run\n";
+    out << "(event dispatch, daily resets). Runs share the worker threads, so\n";
+    out << "wall times include waiting for a core; CPU times are per thread.\n";
+    for (size_t a = 0; a < algorithm_names.size(); a++) {
+        for (size_t r = 0; r < phases[a].size(); r++) {
+            out << "\n" << algorithm_names[a] << " (seed " << base_seed + r << ")\n";
+            write_phase_table(out, phases[a][r]);
+        }
+    }
+}
+
+static void print_usage(const char* program) {
+    cout << "Usage: " << program << " [options]\n"
+         << "  --replications R  independent seeds per algorithm (default 1)\n"
+         << "  --seed S          seed of the first replication (default " << DEFAULT_SIMULATION_SEED << ")\n"
+         << "  --threads T       worker threads (default: one per core)\n"
+         << "  --shards S        split each day of an AMER or ZIAD run into up to S\n"
+         << "                    independent regions on their own threads (default 1)\n"
+         << "  --days D          days per run (default 7)\n"
+         << "  --customers C     customers per day (default 100)\n"
+         << "  --displayed N     stores shown per arrival (default 5)\n"
+         << "  --distance X      pickup radius in degrees (default " << MAX_TRAVEL_DISTANCE << ")\n"
+         << "  --algorithms A    comma-separated names or 'all' (default all)\n"
+         << "  --arrival-profile P  time-of-day arrival curve: flat (default), peaks\n"
+         << "                    (lunch and closing rushes) or a CSV file with\n"
+         << "                    weekday,start,end,weight rows\n"
+         << "  --city-stores N   replace the sample stores with a synthetic city of N\n"
+         << "                    stores fitted to them\n"
+         << "  --city-customers M  with --city-stores, M synthetic customers\n"
+         << "                    (default 10 per store)\n"
+         << "  --sweep           run every combination of the values above and stream\n"
+         << "                    one row per run to the sweep output\n"
+         << "  --sweep-output F  sweep results file (default sweep_results.csv)\n"
+         << "Value lists are 'a', 'a,b,c' or 'first:last[:step]'; lists with more\n"
+         << "than one value require --sweep." << endl;
+}
+
+// Parse the command line into spec; false on bad input
+static bool parse_arguments(int argc, char** argv, SweepSpec& spec, int& threads,
+                            bool& sweep, string& sweep_output, string& arrival_profile,
+                            ScenarioSpec& city) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--sweep") {
+            sweep = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        string value = argv[++i];
+        bool ok = true;
+        if (arg == "--replications") {
+            spec.replications = atoi(value.c_str());
+            ok = spec.replications >= 1;
+        } else if (arg == "--seed") {
+            spec.base_seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--threads") {
+            threads = atoi(value.c_str());
+        } else if (arg == "--shards") {
+            spec.shard_threads = atoi(value.c_str());
+            ok = spec.shard_threads >= 1;
+        } else if (arg == "--days") {
+            ok = parse_int_values(value, spec.days);
+        } else if (arg == "--customers") {
+            ok = parse_int_values(value, spec.customers_per_day);
+        } else if (arg == "--displayed") {
+            ok = parse_int_values(value, spec.n_displayed);
+        } else if (arg == "--distance") {
+            ok = parse_float_values(value, spec.travel_distances);
+        } else if (arg == "--algorithms") {
+            ok = parse_algorithm_list(value, spec.algorithms);
+        } else if (arg == "--sweep-output") {
+            sweep_output = value;
+        } else if (arg == "--arrival-profile") {
+            arrival_profile = value;
+        } else if (arg == "--city-stores") {
+            city.store_count = atoi(value.c_str());
+            ok = city.store_count >= 1;
+        } else if (arg == "--city-customers") {
+            city.customer_count = atoi(value.c_str());
+            ok = city.customer_count >= 1;
+        } else {
+            ok = false;
+        }
+        if (!ok) return false;
+    }
+
+    for (int d : spec.days) if (d < 1) return false;
+    for (int c : spec.customers_per_day) if (c < 1) return false;
+    for (int n : spec.n_displayed) if (n < 1) return false;
+    for (float x : spec.travel_distances) if (x <= 0.0f) return false;
+    if (city.customer_count > 0 && city.store_count == 0) return false;
+
+    // The comparison runs one scenario
+    if (!sweep && (spec.days.size() > 1 || spec.customers_per_day.size() > 1 ||
+                   spec.n_displayed.size() > 1 || spec.travel_distances.size() > 1)) {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SweepSpec spec;
+    int threads = 0;
+    bool sweep = false;
+    string sweep_output = "sweep_results.csv";
+    string arrival_profile = "flat";
+    ScenarioSpec city;
+    city.store_count = 0;
+    city.customer_count = 0;
+    if (!parse_arguments(argc, argv, spec, threads, sweep, sweep_output, arrival_profile, city)) {
+        print_usage(argv[0]);
+        return (argc == 2 && string(argv[1]) == "--help") ? 0 : 1;
+    }
+    int replications = spec.replications;
+    uint64_t base_seed = spec.base_seed;
+
     cout << "=== Food Waste Marketplace Simulation ===" << endl;
-    cout << "Running all ranking algorithms..." << endl;
-    cout << "Detailed logs: detailed_simulation_log.txt" << endl;
-    cout << "Comparison report: algorithm_comparison_report.txt" << endl;
 
     // Load or generate restaurants
     vector<Restaurant> restaurants;
@@ -221,86 +363,143 @@ int main() {
         RestaurantLoader::generate_default_restaurants(restaurants);
     }
 
-    vector<pair<string, RankingAlgorithm>> algorithms = {
-        {"BASELINE", RankingAlgorithm::BASELINE},
-        {"SAMA", RankingAlgorithm::SAMA},
-        {"ANDREW", RankingAlgorithm::ANDREW},
-        {"AMER", RankingAlgorithm::AMER},
-        {"ZIAD", RankingAlgorithm::ZIAD},
-        {"HARMONY", RankingAlgorithm::HARMONY}
-    };
+    ArrivalGenerator shared_generator(base_seed);
+    if (!shared_generator.load_customers_from_csv("customer.csv")) {
+        cout << "No customer CSV found, generating random customers..." << endl;
+    }
+
+    // Synthetic city fitted to the sample market
+    if (city.store_count > 0) {
+        if (city.customer_count == 0) city.customer_count = 10 * city.store_count;
+        city.seed = base_seed;
+        auto start = chrono::steady_clock::now();
+        Scenario scenario = generate_scenario(fit_scenario(restaurants, shared_generator.get_customers()),
+                                              city, threads);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "Generated a city of " << scenario.stores.size() << " stores and "
+             << scenario.customers.size() << " customers in " << fixed << setprecision(2)
+             << seconds << "s" << endl;
+        cout.unsetf(ios::fixed);
+        restaurants.swap(scenario.stores);
+        shared_generator.set_customers(move(scenario.customers));
+    }
+
+    // Time-of-day shape of the shared arrival schedules
+    if (arrival_profile == "peaks") {
+        shared_generator.set_arrival_profile(WeeklyArrivalProfile::meal_peaks());
+    } else if (arrival_profile != "flat") {
+        WeeklyArrivalProfile profile;
+        if (!profile.load_from_csv(arrival_profile)) {
+            return 1;
+        }
+        shared_generator.set_arrival_profile(profile);
+    }
+
+    if (sweep) {
+        cout << "Sweeping " << spec.job_count() << " runs on "
+             << (threads > 0 ? threads : ThreadPool::default_thread_count()) << " threads..." << endl;
+        ofstream out(sweep_output);
+        int jobs = run_sweep(spec, restaurants, shared_generator, out, threads);
+        cout << "Sweep finished: " << jobs << " rows written to " << sweep_output << endl;
+        return 0;
+    }
+
+    cout << "Running all ranking algorithms..." << endl;
+    cout << "Detailed logs: detailed_simulation_log.txt" << endl;
+    cout << "Comparison report: algorithm_comparison_report.txt" << endl;
+
+    ScenarioConfig config = expand_sweep(spec).front().config;
+    vector<pair<string, RankingAlgorithm>> algorithms;
+    for (int a : spec.algorithms) {
+        algorithms.push_back(ranking_algorithms()[a]);
+    }
 
     vector<pair<string, SimulationMetrics>> all_metrics;
 
     // Generate shared simulation data (Customers & Arrivals)
     // Ensures fair comparison across all algorithms
     cout << "Generating customers and arrival times (shared across all algorithms)..." << endl;
-    
-    ArrivalGenerator shared_generator(12345);
-    if (!shared_generator.load_customers_from_csv("customer.csv")) {
-        cout << "No customer CSV found, generating random customers..." << endl;
-    }
-    
-    // Customer Pool (Account for 7 days + churn)
-    vector<Customer> shared_customer_pool;
-    for (int i = 0; i < 100 * 2; i++) {
-        Customer customer = shared_generator.generate_customer(i, restaurants);
-        shared_customer_pool.push_back(customer);
-    }
-    
-    // Arrival Times (7 Days)
-    vector<vector<Timestamp>> shared_arrival_times;
-    for (int day = 0; day < 7; day++) {
-        vector<Timestamp> day_times = shared_generator.generate_arrival_times(100);
-        shared_arrival_times.push_back(day_times);
+
+    // Replication r uses seed base_seed + r for its inputs and its engines
+    int num_algorithms = (int)algorithms.size();
+    vector<SharedInputs> inputs(replications);
+    ThreadPool pool(min(replications * num_algorithms, threads > 0 ? threads : ThreadPool::default_thread_count()));
+    for (int r = 0; r < replications; r++) {
+        pool.submit([&, r]() {
+            inputs[r] = generate_shared_inputs(shared_generator, base_seed + r, restaurants, config);
+        });
     }
+    pool.wait();
     
-    cout << "Generated " << shared_customer_pool.size() << " customers and " 
-              << shared_arrival_times.size() << " days of arrival times." << endl;
+    cout << "Generated " << inputs[0].customer_pool.size() << " customers and " 
+              << inputs[0].arrival_times.size() << " days of arrival times";
+    if (replications > 1) cout << " for each of " << replications << " replications";
+    cout << "." << endl;
 
     // Simulation Loop
+    // Engines share only read-only inputs, so every (replication, algorithm)
+    // pair runs as its own task. The first replication also keeps its log
+    // and CSV in private buffers, which are merged below in algorithm order,
+    // so the output files do not depend on scheduling.
+    vector<ostringstream> logs(num_algorithms);
+    vector<ostringstream> csvs(num_algorithms);
+    vector<vector<SimulationMetrics>> runs(num_algorithms, vector<SimulationMetrics>(replications));
+    vector<vector<PhaseTimes>> phases(num_algorithms, vector<PhaseTimes>(replications));
+
+    cout << "Running " << num_algorithms << " algorithms";
+    if (replications > 1) cout << " x " << replications << " replications";
+    cout << " on " << pool.size() << " threads..." << endl;
+
+    for (int r = 0; r < replications; r++) {
+        for (int a = 0; a < num_algorithms; a++) {
+            pool.submit([&, r, a]() {
+                runs[a][r] = run_algorithm(algorithms[a].first, algorithms[a].second, base_seed + r, config,
+                                           restaurants, inputs[r],
+                                           r == 0 ? &logs[a] : nullptr, r == 0 ? &csvs[a] : nullptr,
+                                           &phases[a][r]);
+            });
+        }
+    }
+    pool.wait();
+
     ofstream detailed_log("detailed_simulation_log.txt");
-    
-    for (const auto& algo_pair : algorithms) {
-        cout << "Running " << algo_pair.first << " algorithm..." << endl;
-        
-        detailed_log << "\n" << string(100, '=') << "\n";
-        detailed_log << "SIMULATION: " << algo_pair.first << " ALGORITHM\n";
-        detailed_log << string(100, '=') << "\n";
-        
-        SimulationEngine engine(5, "", algo_pair.second);
-        engine.initialize(restaurants);
-        engine.set_output_stream(&detailed_log);
-        
-        // Inject shared data
-        engine.set_customer_pool(shared_customer_pool);
-        engine.set_arrival_times(shared_arrival_times);
-        
-        engine.run_multi_day_simulation(7, 100);
-        
-        // Log results
-        detailed_log << "\n" << string(100, '=') << "\n";
-        detailed_log << algo_pair.first << " ALGORITHM RESULTS\n";
-        detailed_log << string(100, '=') << "\n";
-        engine.get_metrics().print_summary_to_stream(detailed_log);
-        
+    for (int a = 0; a < num_algorithms; a++) {
+        detailed_log << logs[a].str();
+
         // Export CSV
-        string csv_filename = "simulation_results_" + algo_pair.first + ".csv";
-        engine.export_results(csv_filename);
-        
-        all_metrics.push_back({algo_pair.first, engine.get_metrics()});
-        
-        cout << "Completed " << algo_pair.first << " algorithm." << endl;
+        string csv_filename = "simulation_results_" + algorithms[a].first + ".csv";
+        ofstream csv(csv_filename);
+        csv << csvs[a].str();
+
+        all_metrics.push_back({algorithms[a].first, runs[a][0]});
+
+        cout << "Completed " << algorithms[a].first << " algorithm." << endl;
     }
     
     detailed_log.close();
 
     // Final Report
-    write_comparison_report(all_metrics, "algorithm_comparison_report.txt");
+    vector<string> algorithm_names;
+    for (const auto& algo_pair : algorithms) {
+        algorithm_names.push_back(algo_pair.first);
+    }
+    write_comparison_report(all_metrics, "algorithm_comparison_report.txt", config,
+                            replications > 1 ? &runs : nullptr, algorithm_names);
+
+    // Phase breakdown (builds with -DSIM_PHASE_TIMING only)
+    if (phase_timing_enabled()) {
+        write_phase_report("phase_timing_report.txt", algorithm_names, base_seed, phases);
+        cout << "\nPhase timing (first replication):" << endl;
+        for (int a = 0; a < num_algorithms; a++) {
+            cout << "\n" << algorithm_names[a] << endl;
+            write_phase_table(cout, phases[a][0]);
+        }
+    }
     
     cout << "\n========================================" << endl;
     cout << "All simulations completed!" << endl;
     cout << "Results saved to: algorithm_comparison_report.txt" << endl;
+    if (phase_timing_enabled()) cout << "Phase timing saved to: phase_timing_report.txt" << endl;
     cout << "Individual CSV files saved for each algorithm." << endl;
     cout << "========================================" << endl;
 